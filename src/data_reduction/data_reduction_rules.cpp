@@ -88,11 +88,11 @@ void rr3(PaceGraph &graph) {
  * upper_bound - lb commit a < b in partial_order.
  *
  */
-void rrlarge(PaceGraph &graph) {
+void rrlarge(PaceGraph &graph, const CancellationToken &cancellation) {
     long ub = graph.ub;
     SimpleLBParameter parameter;
     parameter.usePotentialMatrix = false;
-    long lb = simpleLB(graph, parameter);
+    long lb = simpleLB(graph, parameter, cancellation);
 
     for (int a = 0; a < graph.size_free; a++) {
         for (int b = a + 1; b < graph.size_free; b++) {
@@ -187,7 +187,8 @@ void rrtransitive(PaceGraph &graph) {
     }
 }
 
-void apply_reduction_rules(PaceGraph &graph) {
+void apply_reduction_rules(PaceGraph &graph,
+                           const CancellationToken &cancellation) {
     if (!graph.init_crossing_matrix_if_necessary()) {
         return;
     }
@@ -195,7 +196,13 @@ void apply_reduction_rules(PaceGraph &graph) {
     rr1(graph);
     rr2(graph);
     // rr3(graph);
-    rrlarge(graph);
+    if (cancellation.is_cancelled()) {
+        return;
+    }
+    rrlarge(graph, cancellation);
+    if (cancellation.is_cancelled()) {
+        return;
+    }
     rrtransitive(graph);
     rrlo1(graph);
     // Uncomment this to re-enable rrlo2.
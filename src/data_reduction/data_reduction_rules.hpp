@@ -1,15 +1,23 @@
 #ifndef PACE2024_DATA_REDUCTION_RULES_H
 #define PACE2024_DATA_REDUCTION_RULES_H
 
+#include "../pace_graph/cancellation.hpp"
 #include "../pace_graph/pace_graph.hpp"
 
 void rr1(PaceGraph &graph);
 void rr2(PaceGraph &graph);
 void rr3(PaceGraph &graph);
-void rrlarge(PaceGraph &graph);
+void rrlarge(PaceGraph &graph,
+             const CancellationToken &cancellation = CancellationToken());
 bool rrlo1(PaceGraph &graph);
 bool rrlo2(PaceGraph &graph);
 void rrtransitive(PaceGraph &graph);
-void apply_reduction_rules(PaceGraph &graph);
+/**
+ * Applies the reduction rules. When cancelled, the remaining rules are
+ * skipped; the rules applied so far are still valid.
+ */
+void apply_reduction_rules(
+    PaceGraph &graph,
+    const CancellationToken &cancellation = CancellationToken());
 
 #endif // PACE2024_DATA_REDUCTION_RULES_H
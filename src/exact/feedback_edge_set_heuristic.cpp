@@ -1,5 +1,13 @@
 
 #include "feedback_edge_set_heuristic.hpp"
+#include "../pace_graph/random.hpp"
+
+void FeedbackEdgeHeuristicParameter::load(const Config &config) {
+    config.load("fes_heuristic.priority", priority);
+    config.load("fes_heuristic.restriction", restriction);
+    config.load("fes_heuristic.search_magnitude", search_magnitude);
+    config.load("fes_heuristic.imp_iterations", imp_iterations);
+}
 
 long calculateCost(std::vector<std::shared_ptr<Edge>> &sol) {
     long cost = 0;
@@ -58,8 +66,7 @@ std::vector<std::shared_ptr<Edge>>
 metaRapsConstruction(FeedbackEdgeInstance &instance,
                      FeedbackEdgeHeuristicParameter &parameter) {
     init_edge_circles(instance);
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    auto &gen = thread_rng();
     std::uniform_int_distribution<> functionDistribution(0, 3);
     std::uniform_real_distribution<> probDistribution(0.0, 1.0);
 
@@ -186,8 +193,7 @@ neighbourhoodSearch(FeedbackEdgeInstance &instance,
                     std::vector<std::shared_ptr<Edge>> &solution,
                     FeedbackEdgeHeuristicParameter &parameter, long lb) {
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    auto &gen = thread_rng();
     std::uniform_real_distribution<> dis(0.0, 1.0);
 
     std::vector<std::shared_ptr<Edge>> bestSolution = solution;
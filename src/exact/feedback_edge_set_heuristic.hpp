@@ -5,6 +5,7 @@
 #ifndef PACE2024_FEEDBACK_EDGE_SET_HEURISTIC_HPP
 #define PACE2024_FEEDBACK_EDGE_SET_HEURISTIC_HPP
 
+#include "../pace_graph/config.hpp"
 #include "feedback_edge_set_solver.hpp"
 
 class FeedbackEdgeHeuristicParameter {
@@ -13,6 +14,12 @@ class FeedbackEdgeHeuristicParameter {
     double restriction = 0.35;
     double search_magnitude = 0.3;
     int imp_iterations = 10;
+
+    /**
+     * Overrides the fields that are given in config as
+     * "fes_heuristic.<field>".
+     */
+    void load(const Config &config);
 };
 
 void approximateFeedbackEdgeSet(FeedbackEdgeInstance &instance,
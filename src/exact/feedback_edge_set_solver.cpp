@@ -20,11 +20,12 @@ void Circle::permuteEdges() {
 
 Order FeedbackEdgeSetSolver::tryToSolveByMatchingUBAndLB(PaceGraph &graph) {
     SimpleLBParameter parameter;
+    parameter.load(solver_config());
     auto lb = simpleLB(graph, parameter);
 
     Order order = largeGraphHeuristic(
-        graph, [&]() { return this->time_percentage_past() < 0.8; },
-        [&]() { return this->time_percentage_past(); });
+        graph, cancellation_after(0.8),
+        cancellation_after(time_percentage_past() + 0.2));
     
     long crossings = order.count_crossings(graph);
     if (crossings == lb) {
@@ -59,6 +60,7 @@ Order FeedbackEdgeSetSolver::run(PaceGraph &graph) {
     Order goodOrder = Order(0);
 
     GeneticHeuristicParameter geneticHeuristicParameter;
+    geneticHeuristicParameter.load(solver_config());
     GeneticHeuristic geneticHeuristic(
         [start, time_for_heuristic, this](auto it) {
             if (this->fes_parameter.useFastHeuristic) {
@@ -70,13 +72,18 @@ Order FeedbackEdgeSetSolver::run(PaceGraph &graph) {
                                                                       start);
             return elapsed < time_for_heuristic;
         },
-        geneticHeuristicParameter);
+        geneticHeuristicParameter,
+        fes_parameter.useFastHeuristic
+            ? CancellationToken()
+            : CancellationToken::with_timeout(time_for_heuristic,
+                                              cancellation()));
 
     goodOrder = geneticHeuristic.solve(graph);
 
     long crossings = goodOrder.count_crossings(graph);
 
     SimpleLBParameter parameter;
+    parameter.load(solver_config());
     parameter.usePotentialMatrix = false;
     auto lb = simpleLB(graph, parameter);
 
@@ -193,6 +200,7 @@ void FeedbackEdgeSetSolver::solveFeedbackEdgeSet(
     long lb = lbFeedbackEdgeSet(instance, 0);
 
     FeedbackEdgeHeuristicParameter heuristicParameter;
+    heuristicParameter.load(solver_config());
     approximateFeedbackEdgeSet(instance, heuristicParameter, lb);
     long ub = instance.ub;
     std::cerr << "UB: " << ub;
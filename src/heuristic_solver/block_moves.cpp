@@ -0,0 +1,78 @@
+#include "block_moves.hpp"
+
+#include <algorithm>
+
+WindowPairSums::WindowPairSums(const PaceGraph &graph, const Order &order,
+                               int maxLength)
+    : crossing(graph.crossing), order(order), maxLength(maxLength),
+      sums(static_cast<long>(graph.size_free) * (maxLength + 1), 0) {
+    update(0, graph.size_free - 1);
+}
+
+void WindowPairSums::compute_row(int i) {
+    const int size = order.position_to_vertex.size();
+    const int *diff_row = crossing.matrix_diff[order.position_to_vertex[i]];
+    long *row = sums.data() + static_cast<long>(i) * (maxLength + 1);
+    const long *next = row + maxLength + 1;
+
+    // A window starting at i consists of the pairs of the window starting at
+    // i + 1 and the pairs (i, q).
+    row[1] = 0;
+    long pairsWithI = 0;
+    int lengthEnd = std::min(maxLength, size - i);
+    for (int length = 2; length <= lengthEnd; ++length) {
+        pairsWithI += diff_row[order.position_to_vertex[i + length - 1]];
+        row[length] = next[length - 1] + pairsWithI;
+    }
+}
+
+void WindowPairSums::update(int from, int to) {
+    for (int i = to; i >= std::max(0, from - maxLength + 1); --i) {
+        compute_row(i);
+    }
+}
+
+long block_moves(PaceGraph &graph, Order &order, int maxSpan,
+                 const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+    maxSpan = std::min(maxSpan, size);
+    if (maxSpan < 2) {
+        return 0;
+    }
+
+    WindowPairSums pairSums(graph, order, maxSpan);
+
+    long improvement = 0;
+    bool improved = true;
+    while (improved && !cancellation.is_cancelled()) {
+        improved = false;
+        for (int first = 0; first + 1 < size && !cancellation.is_cancelled();
+             ++first) {
+            long bestCostChange = 0;
+            int bestMiddle = -1;
+            int bestLast = -1;
+
+            int lastEnd = std::min(size, first + maxSpan);
+            for (int last = first + 2; last <= lastEnd; ++last) {
+                for (int middle = first + 1; middle < last; ++middle) {
+                    long costChange =
+                        pairSums.swap_cost_change(first, middle, last);
+                    if (costChange < bestCostChange) {
+                        bestCostChange = costChange;
+                        bestMiddle = middle;
+                        bestLast = last;
+                    }
+                }
+            }
+
+            if (bestCostChange < 0) {
+                order.swap_blocks(first, bestMiddle, bestLast, bestCostChange);
+                pairSums.update(first, bestLast - 1);
+                improvement += bestCostChange;
+                improved = true;
+            }
+        }
+    }
+
+    return improvement;
+}
@@ -0,0 +1,59 @@
+#ifndef PACE2024_BLOCK_MOVES_HPP
+#define PACE2024_BLOCK_MOVES_HPP
+
+#include "../pace_graph/cancellation.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+#include <vector>
+
+/**
+ * Sums of matrix_diff over all pairs inside short windows of an order, i.e.
+ * get(i, length) is the sum of matrix_diff[order[p]][order[q]] over
+ * i <= p < q < i + length. Only windows of up to maxLength positions are
+ * stored, which needs n * maxLength longs.
+ */
+class WindowPairSums {
+  private:
+    const CrossingMatrix &crossing;
+    const Order &order;
+    int maxLength;
+    std::vector<long> sums;
+
+    void compute_row(int i);
+
+  public:
+    WindowPairSums(const PaceGraph &graph, const Order &order, int maxLength);
+
+    long get(int i, int length) const {
+        return sums[static_cast<long>(i) * (maxLength + 1) + length];
+    }
+
+    /**
+     * Recomputes all windows that contain a position in [from, to], e.g.
+     * after the vertices at these positions moved.
+     */
+    void update(int from, int to);
+
+    /**
+     * @return the cost change of swapping the adjacent blocks of positions
+     * [first, middle) and [middle, last) in O(1). last - first must be at
+     * most maxLength.
+     */
+    long swap_cost_change(int first, int middle, int last) const {
+        return -(get(first, last - first) - get(first, middle - first) -
+                 get(middle, last - middle));
+    }
+};
+
+/**
+ * Moves blocks of consecutive vertices past each other as long as this
+ * improves the order (Or-opt). Every pair of adjacent blocks spanning at most
+ * maxSpan positions is evaluated in O(1) with WindowPairSums. Needs the
+ * crossing matrix.
+ *
+ * @return the improvement in the cost of the order
+ */
+long block_moves(PaceGraph &graph, Order &order, int maxSpan,
+                 const CancellationToken &cancellation);
+
+#endif // PACE2024_BLOCK_MOVES_HPP
@@ -0,0 +1,123 @@
+#include "crossover.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+Order order_crossover(const Order &first, const Order &second,
+                      Xoshiro256 &rng) {
+    const int size = first.position_to_vertex.size();
+    int begin = rng.next_below(size);
+    int end = begin + 1 + rng.next_below(size - begin);
+
+    std::vector<int> child(size);
+    std::vector<char> taken(size, false);
+    for (int position = begin; position < end; ++position) {
+        int v = first.position_to_vertex[position];
+        child[position] = v;
+        taken[v] = true;
+    }
+
+    int position = end % size;
+    for (int i = 0; i < size; ++i) {
+        int v = second.position_to_vertex[(end + i) % size];
+        if (!taken[v]) {
+            child[position] = v;
+            position = (position + 1) % size;
+        }
+    }
+    return Order(child);
+}
+
+Order position_based_crossover(const Order &first, const Order &second,
+                               Xoshiro256 &rng) {
+    const int size = first.position_to_vertex.size();
+
+    std::vector<int> child(size, -1);
+    std::vector<char> taken(size, false);
+    for (int position = 0; position < size; ++position) {
+        if (rng() & 1) {
+            int v = first.position_to_vertex[position];
+            child[position] = v;
+            taken[v] = true;
+        }
+    }
+
+    int position = 0;
+    for (int v : second.position_to_vertex) {
+        if (taken[v]) {
+            continue;
+        }
+        while (child[position] != -1) {
+            position++;
+        }
+        child[position] = v;
+    }
+    return Order(child);
+}
+
+Order median_rank_crossover(const Order &first, const Order &second,
+                            Xoshiro256 &rng) {
+    const int size = first.position_to_vertex.size();
+    double weight = rng.next_double();
+
+    std::vector<double> rank(size);
+    for (int v = 0; v < size; ++v) {
+        rank[v] = weight * first.vertex_to_position[v] +
+                  (1 - weight) * second.vertex_to_position[v];
+    }
+
+    // Ties are broken by the order of first.
+    std::vector<int> child = first.position_to_vertex;
+    std::stable_sort(child.begin(), child.end(),
+                     [&rank](int u, int v) { return rank[u] < rank[v]; });
+    return Order(child);
+}
+
+Order crossover(const Order &first, const Order &second, CrossoverType type,
+                Xoshiro256 &rng) {
+    if (type == CrossoverType::Random) {
+        type = static_cast<CrossoverType>(rng.next_below(3));
+    }
+
+    switch (type) {
+    case CrossoverType::Order:
+        return order_crossover(first, second, rng);
+    case CrossoverType::PositionBased:
+        return position_based_crossover(first, second, rng);
+    default:
+        return median_rank_crossover(first, second, rng);
+    }
+}
+
+long footrule_distance(const Order &first, const Order &second) {
+    long distance = 0;
+    const int size = first.vertex_to_position.size();
+    for (int v = 0; v < size; ++v) {
+        distance +=
+            std::abs(first.vertex_to_position[v] - second.vertex_to_position[v]);
+    }
+    return distance;
+}
+
+long kendall_tau_distance(const Order &first, const Order &second) {
+    const int size = first.position_to_vertex.size();
+
+    // Fenwick tree over the positions in first of the vertices seen so far.
+    std::vector<int> tree(size + 1, 0);
+    long distance = 0;
+    for (int seen = 0; seen < size; ++seen) {
+        int position =
+            first.vertex_to_position[second.position_to_vertex[seen]];
+
+        int smaller = 0;
+        for (int i = position; i > 0; i -= i & -i) {
+            smaller += tree[i];
+        }
+        distance += seen - smaller;
+
+        for (int i = position + 1; i <= size; i += i & -i) {
+            tree[i]++;
+        }
+    }
+    return distance;
+}
@@ -0,0 +1,61 @@
+#ifndef PACE2024_CROSSOVER_HPP
+#define PACE2024_CROSSOVER_HPP
+
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/random.hpp"
+
+enum class CrossoverType {
+    /** Order crossover (OX), see order_crossover. */
+    Order,
+    /** See position_based_crossover. */
+    PositionBased,
+    /** See median_rank_crossover. */
+    MedianRank,
+    /** One of the above, chosen uniformly at random for every child. */
+    Random
+};
+
+/**
+ * Order crossover (OX): the child keeps a random segment of positions of
+ * first. The remaining vertices are placed in the order of second, starting
+ * after the segment and wrapping around.
+ */
+Order order_crossover(const Order &first, const Order &second,
+                      Xoshiro256 &rng);
+
+/**
+ * Position-based crossover: the child keeps the vertex of first at every
+ * position with probability 1/2. The other positions are filled with the
+ * remaining vertices in the order of second.
+ */
+Order position_based_crossover(const Order &first, const Order &second,
+                               Xoshiro256 &rng);
+
+/**
+ * Consensus of both parents: sorts the vertices by a random convex
+ * combination of their positions in first and second.
+ */
+Order median_rank_crossover(const Order &first, const Order &second,
+                            Xoshiro256 &rng);
+
+/**
+ * @return the child of first and second for the given crossover type. The
+ * child does not track its crossings.
+ */
+Order crossover(const Order &first, const Order &second, CrossoverType type,
+                Xoshiro256 &rng);
+
+/**
+ * @return the Spearman footrule distance of the orders, i.e. the sum of the
+ * position differences of all vertices.
+ */
+long footrule_distance(const Order &first, const Order &second);
+
+/**
+ * @return the Kendall tau distance of the orders, i.e. the number of vertex
+ * pairs whose order differs. Counts the inversions with a Fenwick tree in
+ * O(n log n).
+ */
+long kendall_tau_distance(const Order &first, const Order &second);
+
+#endif // PACE2024_CROSSOVER_HPP
@@ -0,0 +1,85 @@
+#include "elite_pool.hpp"
+#include "crossover.hpp"
+
+#include <algorithm>
+#include <limits>
+
+bool ElitePool::insert(const Order &order, long cost) {
+    int closest = -1;
+    long closestDistance = std::numeric_limits<long>::max();
+    int worst = -1;
+    for (int i = 0; i < size(); ++i) {
+        Order member(members[i].position_to_vertex);
+        long distance = kendall_tau_distance(member, order);
+        if (distance < closestDistance) {
+            closest = i;
+            closestDistance = distance;
+        }
+        if (worst == -1 || members[i].cost > members[worst].cost) {
+            worst = i;
+        }
+    }
+
+    if (closestDistance < minimumDistance) {
+        if (members[closest].cost <= cost) {
+            return false;
+        }
+        members[closest] = {order.position_to_vertex, cost};
+        return true;
+    }
+
+    if (size() < capacity) {
+        members.push_back({order.position_to_vertex, cost});
+        return true;
+    }
+    if (worst != -1 && cost < members[worst].cost) {
+        members[worst] = {order.position_to_vertex, cost};
+        return true;
+    }
+    return false;
+}
+
+Order path_relinking(PaceGraph &graph, const Order &from, const Order &to,
+                     int numberOfLocalSearches,
+                     LocalSearchParameter &localSearchParameter,
+                     const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+    int differentPositions = 0;
+    for (int i = 0; i < size; ++i) {
+        if (from.position_to_vertex[i] != to.position_to_vertex[i]) {
+            differentPositions++;
+        }
+    }
+
+    Order current = from;
+    Order best = from;
+    long bestCost = std::numeric_limits<long>::max();
+    if (differentPositions == 0) {
+        return best;
+    }
+
+    // Every move fixes at least one position, so there are at most
+    // differentPositions moves.
+    int stepsBetweenLocalSearches =
+        std::max(1, differentPositions / (numberOfLocalSearches + 1));
+    int steps = 0;
+    for (int i = 0; i < size && !cancellation.is_cancelled(); ++i) {
+        int v = to.position_to_vertex[i];
+        if (current.get_vertex(i) == v) {
+            continue;
+        }
+        current.move_vertex(v, i, current.move_cost_change(v, i));
+        steps++;
+
+        if (steps % stepsBetweenLocalSearches == 0 && i + 1 < size) {
+            Order intermediate = current;
+            local_search(graph, intermediate, localSearchParameter,
+                         cancellation);
+            if (intermediate.get_crossings() < bestCost) {
+                bestCost = intermediate.get_crossings();
+                best = intermediate;
+            }
+        }
+    }
+    return best;
+}
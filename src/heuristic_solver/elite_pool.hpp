@@ -0,0 +1,59 @@
+#ifndef PACE2024_ELITE_POOL_HPP
+#define PACE2024_ELITE_POOL_HPP
+
+#include "../pace_graph/cancellation.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+#include "../pace_graph/random.hpp"
+#include "local_search.hpp"
+
+#include <vector>
+
+/**
+ * Archive of the best, pairwise different local optima. Two orders are
+ * considered similar if their Kendall tau distance is below minimumDistance.
+ */
+class ElitePool {
+  public:
+    struct Member {
+        std::vector<int> position_to_vertex;
+        long cost;
+    };
+
+  private:
+    int capacity;
+    long minimumDistance;
+    std::vector<Member> members;
+
+  public:
+    ElitePool(int capacity, long minimumDistance)
+        : capacity(capacity), minimumDistance(minimumDistance) {}
+
+    /**
+     * Adds the order if it is not similar to a member that costs at most as
+     * much. A similar, more expensive member is replaced. Otherwise the
+     * order replaces the most expensive member if the pool is full and the
+     * order is cheaper.
+     * @return true if the order was added
+     */
+    bool insert(const Order &order, long cost);
+
+    int size() const { return members.size(); }
+    const Member &operator[](int i) const { return members[i]; }
+};
+
+/**
+ * Path relinking: moves the vertices of from one by one to their position in
+ * to, from left to right. Runs local search on numberOfLocalSearches orders
+ * evenly spread along the path.
+ *
+ * @param from the start of the path. Has to track its crossings
+ * @return the best of the locally optimized orders, tracking its crossings,
+ * or from if the orders are equal
+ */
+Order path_relinking(PaceGraph &graph, const Order &from, const Order &to,
+                     int numberOfLocalSearches,
+                     LocalSearchParameter &localSearchParameter,
+                     const CancellationToken &cancellation);
+
+#endif // PACE2024_ELITE_POOL_HPP
@@ -1,9 +1,56 @@
 #include "genetic_algorithm.hpp"
 #include "../lb/simple_lb.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+#include "elite_pool.hpp"
 #include "local_search.hpp"
-#include "mean_position_heuristic.hpp"
-#include <chrono>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <mutex>
+
+/** Best order of all islands. */
+struct GeneticHeuristic::SharedBest {
+    std::mutex mutex;
+    std::vector<int> position_to_vertex;
+    long cost;
+    /** Incremented on every improvement. */
+    int version = 0;
+    /** The island that found the order, -1 for the initial order. */
+    int island = -1;
+
+    /** Stores the order of the given island if it is the best one. */
+    void offer(const Order &order, long orderCost, int fromIsland) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (orderCost < cost) {
+            position_to_vertex = order.position_to_vertex;
+            cost = orderCost;
+            island = fromIsland;
+            version++;
+        }
+    }
+
+    /**
+     * Copies the best order into order, if another island found it since
+     * seenVersion and it costs less than worseThan.
+     * @return true if the order was copied
+     */
+    bool migrate(int toIsland, int &seenVersion, long worseThan, Order &order,
+                 long &orderCost) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (version == seenVersion) {
+            return false;
+        }
+        seenVersion = version;
+        if (island == toIsland || cost >= worseThan) {
+            return false;
+        }
+        order = Order(position_to_vertex);
+        orderCost = cost;
+        return true;
+    }
+};
 
 Order GeneticHeuristic::solve(PaceGraph &graph) {
     if (graph.size_free <= 1) {
@@ -20,41 +67,230 @@ Order GeneticHeuristic::solve(PaceGraph &graph) {
 
     SimpleLBParameter lbParameter;
     lbParameter.maxNrOfConflicts = 100000;
-    long lb = simpleLB(graph, lbParameter);
-
-    MeanPositionParameter meanPositionParameter;
-    meanPositionParameter.useLocalSearch = false;
-    meanPositionParameter.useJittering = false;
-    meanPositionParameter.meanType = median;
-    MeanPositionSolver meanPositionHeuristic(
-        [this](int it) { return it == 0 && this->has_time_left(0); },
-        meanPositionParameter);
-    Order bestOrder = meanPositionHeuristic.solve(graph);
-    local_search(graph, bestOrder, localSearchParameter,
-                 [this]() { return this->has_time_left(0); });
-    long bestCost = bestOrder.count_crossings(graph);
+    long lb = simpleLB(graph, lbParameter, cancellation);
 
-    int number_of_iterations = 0;
-    int number_of_iteration_without_improvement = 0;
+    initialOrders = initial_orders(
+        graph, geneticHeuristicParameter.portfolioParameter, cancellation);
+    for (auto &order : initialOrders) {
+        order.track_crossings(graph);
+        local_search(graph, order, localSearchParameter, cancellation);
+    }
+    std::stable_sort(initialOrders.begin(), initialOrders.end(),
+                     [](const Order &a, const Order &b) {
+                         return a.get_crossings() < b.get_crossings();
+                     });
+
+    SharedBest shared;
+    shared.position_to_vertex = initialOrders[0].position_to_vertex;
+    shared.cost = initialOrders[0].get_crossings();
+
+    int islands = available_threads();
+    if (geneticHeuristicParameter.numberOfIslands > 0) {
+        islands =
+            std::min(islands, geneticHeuristicParameter.numberOfIslands);
+    }
+
+    // Cancelled by the island that reaches the lower bound.
+    CancellationToken stop = CancellationToken::with_deadline(
+        std::chrono::steady_clock::time_point::max(), cancellation);
+    std::atomic<int> number_of_iterations{0};
+
+    auto run = [this](PaceGraph &islandGraph, SharedBest &shared, int island,
+                      long lb, const CancellationToken &stop) {
+        if (geneticHeuristicParameter.mode == GeneticMode::Population) {
+            return runPopulationIsland(islandGraph, shared, island, lb, stop);
+        }
+        if (geneticHeuristicParameter.mode ==
+            GeneticMode::IteratedLocalSearch) {
+            return runIteratedLocalSearchIsland(islandGraph, shared, island,
+                                                lb, stop);
+        }
+        return runIsland(islandGraph, shared, island, lb, stop);
+    };
+
+    if (shared.cost != lb) {
+        if (islands == 1) {
+            number_of_iterations += run(graph, shared, 0, lb, stop);
+        } else {
+            std::vector<uint64_t> streams(islands);
+            for (auto &stream : streams) {
+                stream = thread_rng()();
+            }
+            parallel_for(0, islands, 1, [&](int from, int to, int thread) {
+                for (int island = from; island < to; ++island) {
+                    ThreadRngScope rngScope(streams[island]);
+                    auto islandGraph = graph.constraint_overlay();
+                    number_of_iterations +=
+                        run(*islandGraph, shared, island, lb, stop);
+                }
+            });
+        }
+    }
+
+    std::cerr << "# Islands: " << islands << std::endl;
+    std::cerr << "# Iterations: " << number_of_iterations << std::endl;
+
+    return Order(shared.position_to_vertex);
+}
+
+void GeneticHeuristicParameter::load(const Config &config) {
+    config.load_enum("genetic.mode", mode);
+    config.load(
+        "genetic.forceMoveAllDirectNodesAfterIterationWithNoImprovement",
+        forceMoveAllDirectNodesAfterIterationWithNoImprovement);
+    config.load("genetic.numberOfForceSwapPositions",
+                numberOfForceSwapPositions);
+    config.load("genetic.numberOfForceSwapStepSize", numberOfForceSwapStepSize);
+    config.load_enum("genetic.stallEngine", stallEngine);
+    config.load("genetic.tabuSearchTimeLimitMs", tabuSearchTimeLimitMs);
+    config.load("genetic.elitePoolSize", elitePoolSize);
+    config.load("genetic.eliteMinimumDistance", eliteMinimumDistance);
+    config.load("genetic.pathRelinkingInterval", pathRelinkingInterval);
+    config.load("genetic.pathRelinkingLocalSearches",
+                pathRelinkingLocalSearches);
+    config.load_enum("genetic.siftingTypeInitialSearch",
+                     siftingTypeInitialSearch);
+    config.load_enum("genetic.siftingInsertionTypeInitialSearch",
+                     siftingInsertionTypeInitialSearch);
+    config.load_enum("genetic.siftingTypeImprovementSearch",
+                     siftingTypeImprovementSearch);
+    config.load_enum("genetic.siftingInsertionTypeImprovementSearch",
+                     siftingInsertionTypeImprovementSearch);
+    config.load("genetic.worklistImprovementSearch", worklistImprovementSearch);
+    config.load("genetic.adaptiveSifting", adaptiveSifting);
+    config.load("genetic.numberOfIslands", numberOfIslands);
+    config.load("genetic.migrationInterval", migrationInterval);
+    config.load("genetic.populationSize", populationSize);
+    config.load_enum("genetic.crossoverType", crossoverType);
+    config.load("genetic.minimumDistance", minimumDistance);
+    config.load("genetic.populationRestartAfter", populationRestartAfter);
+    config.load_enum("genetic.perturbationType", perturbationType);
+    config.load("genetic.ilsMaxInsertionDistance", ilsMaxInsertionDistance);
+    config.load_enum("genetic.ilsAcceptance", ilsAcceptance);
+    config.load("genetic.ilsAcceptanceThreshold", ilsAcceptanceThreshold);
+    config.load("genetic.ilsMinStrength", ilsMinStrength);
+    config.load("genetic.ilsAdaptationWindow", ilsAdaptationWindow);
+    config.load("genetic.ilsTargetImprovementRate", ilsTargetImprovementRate);
+    tabuSearchParameter.load(config);
+    portfolioParameter.load(config);
+}
+
+int GeneticHeuristic::runIsland(PaceGraph &graph, SharedBest &shared,
+                                int island, long lb,
+                                const CancellationToken &stop) {
+    LocalSearchParameter localSearchParameter;
+    localSearchParameter.siftingType =
+        geneticHeuristicParameter.siftingTypeInitialSearch;
+    localSearchParameter.siftingInsertionType =
+        geneticHeuristicParameter.siftingInsertionTypeInitialSearch;
 
-    Order lookAtOrder = bestOrder;
+    // The restarts and the improvement of a stalled order get their own
+    // bandits, as different strategies may pay off.
+    SiftingBandit initialBandit;
+    SiftingBandit improvementBandit;
+    auto useBandit = [&](SiftingBandit &bandit) {
+        if (geneticHeuristicParameter.adaptiveSifting) {
+            localSearchParameter.bandit = &bandit;
+        }
+    };
+    useBandit(initialBandit);
+
+    Order lookAtOrder(graph.size_free);
+    long bestCost;
+    int seenVersion;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        lookAtOrder = Order(shared.position_to_vertex);
+        bestCost = shared.cost;
+        seenVersion = shared.version;
+    }
+    lookAtOrder.track_crossings(graph);
     long lookAtCost = bestCost;
 
+    // Publishes an order that is better than everything this island found.
+    auto improveBest = [&](const Order &order, long cost) {
+        if (cost >= bestCost) {
+            return;
+        }
+        bestCost = cost;
+        shared.offer(order, cost, island);
+        if (cost == lb) {
+            stop.cancel();
+        }
+    };
+
+    // Continues with the best order of another island if it is better.
+    auto migrate = [&]() {
+        Order migrant(0);
+        long cost;
+        if (shared.migrate(island, seenVersion, lookAtCost, migrant, cost)) {
+            migrant.track_crossings(graph);
+            lookAtOrder = migrant;
+            lookAtCost = cost;
+            bestCost = std::min(bestCost, cost);
+        }
+    };
+
+    ElitePool elitePool(
+        geneticHeuristicParameter.elitePoolSize,
+        static_cast<long>(geneticHeuristicParameter.eliteMinimumDistance *
+                          graph.size_free));
+
+    // Relinks two random members of the pool.
+    auto relink = [&]() {
+        auto &rng = thread_rng();
+        int first = rng.next_below(elitePool.size());
+        int second = rng.next_below(elitePool.size() - 1);
+        if (second >= first) {
+            second++;
+        }
+
+        Order from(elitePool[first].position_to_vertex);
+        from.track_crossings(graph);
+        Order to(elitePool[second].position_to_vertex);
+        Order relinked = path_relinking(
+            graph, from, to,
+            geneticHeuristicParameter.pathRelinkingLocalSearches,
+            localSearchParameter, stop);
+
+        long relinkedCost = relinked.get_crossings();
+        elitePool.insert(relinked, relinkedCost);
+        if (relinkedCost <= lookAtCost) {
+            lookAtOrder = relinked;
+            lookAtCost = relinkedCost;
+            improveBest(relinked, relinkedCost);
+        }
+    };
+
+    int number_of_iterations = 0;
+    int number_of_iteration_without_improvement = 0;
+
     std::vector<int> force_swap_position_array(graph.size_free - 1);
     for (int i = 0; i < graph.size_free - 1; ++i) {
         force_swap_position_array[i] = i;
     }
 
-    while (has_time_left(number_of_iterations) && lb != bestCost) {
+    while (has_time_left(number_of_iterations) && !stop.is_cancelled()) {
+        if (number_of_iterations %
+                geneticHeuristicParameter.migrationInterval ==
+            0) {
+            migrate();
+        }
+        if (elitePool.size() >= 2 &&
+            number_of_iterations %
+                    geneticHeuristicParameter.pathRelinkingInterval ==
+                0) {
+            relink();
+        }
+
         Order newOrder(graph.size_free);
         newOrder.permute();
+        newOrder.track_crossings(graph);
 
-        local_search(graph, newOrder, localSearchParameter,
-                     [this, number_of_iterations]() {
-                         return has_time_left(number_of_iterations);
-                     });
+        local_search(graph, newOrder, localSearchParameter, stop);
 
-        long newCost = newOrder.count_crossings(graph);
+        long newCost = newOrder.get_crossings();
+        elitePool.insert(newOrder, newCost);
         if (newCost <= lookAtCost) {
             lookAtOrder = newOrder;
             lookAtCost = newCost;
@@ -62,10 +298,7 @@ Order GeneticHeuristic::solve(PaceGraph &graph) {
                 number_of_iteration_without_improvement = 0;
             }
 
-            if (newCost < bestCost) {
-                bestOrder = newOrder;
-                bestCost = newCost;
-            }
+            improveBest(newOrder, newCost);
 
         } else {
             number_of_iteration_without_improvement++;
@@ -79,73 +312,102 @@ Order GeneticHeuristic::solve(PaceGraph &graph) {
                 localSearchParameter.siftingInsertionType =
                     geneticHeuristicParameter
                         .siftingInsertionTypeImprovementSearch;
+                localSearchParameter.worklistSifting =
+                    geneticHeuristicParameter.worklistImprovementSearch;
+                useBandit(improvementBandit);
+
+                if (geneticHeuristicParameter.stallEngine ==
+                    StallEngine::TabuSearch) {
+                    auto timeBox = CancellationToken::with_timeout(
+                        std::chrono::milliseconds(
+                            geneticHeuristicParameter.tabuSearchTimeLimitMs),
+                        stop);
+                    newOrder = lookAtOrder.clone();
+                    tabu_search(graph, newOrder,
+                                geneticHeuristicParameter.tabuSearchParameter,
+                                timeBox);
+                    local_search(graph, newOrder, localSearchParameter, stop);
+                    improveBest(newOrder, newOrder.get_crossings());
+                } else {
+                    for (int swapFurther = 1;
+                         swapFurther <=
+                         geneticHeuristicParameter.numberOfForceSwapPositions;
+                         swapFurther +=
+                         geneticHeuristicParameter.numberOfForceSwapStepSize) {
 
-                for (int swapFurther = 1;
-                     swapFurther <=
-                     geneticHeuristicParameter.numberOfForceSwapPositions;
-                     swapFurther +=
-                     geneticHeuristicParameter.numberOfForceSwapStepSize) {
-
-                    if (!has_time_left(number_of_iterations)) {
-                        break;
-                    }
-
-                    bool improvement = true;
-                    while (improvement) {
-                        improvement = false;
-
-                        std::shuffle(force_swap_position_array.begin(),
-                                     force_swap_position_array.end(),
-                                     std::default_random_engine(
-                                         std::chrono::system_clock::now()
-                                             .time_since_epoch()
-                                             .count()));
                         if (!has_time_left(number_of_iterations)) {
                             break;
                         }
 
-                        newOrder = lookAtOrder.clone();
-                        Order orginalOrder = lookAtOrder.clone();
-                        for (int i = 0; i < graph.size_free - 1; i++) {
+                        bool improvement = true;
+                        while (improvement) {
+                            improvement = false;
 
-                            if (!has_time_left(number_of_iterations)) {
+                            std::shuffle(force_swap_position_array.begin(),
+                                         force_swap_position_array.end(),
+                                         thread_rng());
+                            if (stop.is_cancelled()) {
                                 break;
                             }
 
-                            int pos = force_swap_position_array[i];
-                            if (pos + swapFurther >= graph.size_free) {
-                                continue;
-                            }
+                            newOrder = lookAtOrder.clone();
+                            Order orginalOrder = lookAtOrder.clone();
+                            std::vector<int> changedVertices;
+                            for (int i = 0; i < graph.size_free - 1; i++) {
+
+                                if (stop.is_cancelled()) {
+                                    break;
+                                }
+
+                                int pos = force_swap_position_array[i];
+                                if (pos + swapFurther >= graph.size_free) {
+                                    continue;
+                                }
 
-                            int u = orginalOrder.get_vertex(pos);
-                            int v = orginalOrder.get_vertex(pos + swapFurther);
+                                int u = orginalOrder.get_vertex(pos);
+                                int v =
+                                    orginalOrder.get_vertex(pos + swapFurther);
 
-                            if (graph.crossing.lt(u, v)) {
-                                continue;
-                            }
+                                if (graph.crossing.lt(u, v)) {
+                                    continue;
+                                }
+
+                                newOrder.swap_by_vertices(u, v);
 
-                            newOrder.swap_by_vertices(u, v);
-
-                            // force node order to be different
-                            graph.crossing.set_a_lt_b(v, u);
-                            local_search(graph, newOrder, localSearchParameter,
-                                         [this, number_of_iterations]() {
-                                             return has_time_left(
-                                                 number_of_iterations);
-                                         });
-                            graph.crossing.unset_a_lt_b(v, u);
-
-                            newCost = newOrder.count_crossings(graph);
-                            if (newCost <= lookAtCost) {
-                                lookAtOrder = newOrder;
-                                if (newCost < lookAtCost) {
-                                    improvement = true;
-                                    lookAtCost = newCost;
+                                // force node order to be different
+                                bool forced = newOrder.set_a_lt_b(v, u);
+
+                                // The swap changed the surroundings of u, v and
+                                // every vertex between them.
+                                int from = std::min(newOrder.get_position(u),
+                                                    newOrder.get_position(v));
+                                int to = std::max(newOrder.get_position(u),
+                                                  newOrder.get_position(v));
+                                for (int p = from; p <= to; ++p) {
+                                    changedVertices.push_back(
+                                        newOrder.get_vertex(p));
                                 }
 
-                                if (newCost < bestCost) {
-                                    bestOrder = newOrder;
-                                    bestCost = newCost;
+                                local_search(graph, newOrder,
+                                             localSearchParameter, stop,
+                                             changedVertices);
+                                if (forced) {
+                                    newOrder.unset_a_lt_b(v, u);
+                                }
+
+                                // Without the constraint u and v might want to
+                                // move again.
+                                changedVertices.assign({u, v});
+
+                                newCost = newOrder.get_crossings();
+                                if (newCost <= lookAtCost) {
+                                    lookAtOrder = newOrder;
+                                    if (newCost < lookAtCost) {
+                                        improvement = true;
+                                        lookAtCost = newCost;
+                                    }
+
+                                    improveBest(newOrder, newCost);
                                 }
                             }
                         }
@@ -156,17 +418,286 @@ Order GeneticHeuristic::solve(PaceGraph &graph) {
                     geneticHeuristicParameter.siftingTypeInitialSearch;
                 localSearchParameter.siftingInsertionType =
                     geneticHeuristicParameter.siftingInsertionTypeInitialSearch;
+                localSearchParameter.worklistSifting = false;
+                useBandit(initialBandit);
                 number_of_iteration_without_improvement = 0;
 
                 lookAtOrder = Order(graph.size_free);
                 lookAtOrder.permute();
-                lookAtCost = lookAtOrder.count_crossings(graph);
+                lookAtOrder.track_crossings(graph);
+                lookAtCost = lookAtOrder.get_crossings();
             }
         }
         number_of_iterations++;
     }
 
-    std::cerr << "# Iterations: " << number_of_iterations << std::endl;
+    return number_of_iterations;
+}
+
+int GeneticHeuristic::runPopulationIsland(PaceGraph &graph, SharedBest &shared,
+                                          int island, long lb,
+                                          const CancellationToken &stop) {
+    LocalSearchParameter localSearchParameter;
+    localSearchParameter.siftingType =
+        geneticHeuristicParameter.siftingTypeInitialSearch;
+    localSearchParameter.siftingInsertionType =
+        geneticHeuristicParameter.siftingInsertionTypeInitialSearch;
+    SiftingBandit bandit;
+    if (geneticHeuristicParameter.adaptiveSifting) {
+        localSearchParameter.bandit = &bandit;
+    }
+
+    auto &rng = thread_rng();
+    const int populationSize =
+        std::max(2, geneticHeuristicParameter.populationSize);
+    const long minimumDistance = static_cast<long>(
+        geneticHeuristicParameter.minimumDistance * graph.size_free);
+
+    std::vector<Order> population;
+    std::vector<long> costs;
+    long bestCost;
+    int seenVersion;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        population.emplace_back(shared.position_to_vertex);
+        costs.push_back(shared.cost);
+        bestCost = shared.cost;
+        seenVersion = shared.version;
+    }
+    population[0].track_crossings(graph);
+    for (int i = 1; i < initialOrders.size() &&
+                    population.size() < populationSize;
+         ++i) {
+        population.emplace_back(initialOrders[i].position_to_vertex);
+        population.back().track_crossings(graph);
+        costs.push_back(population.back().get_crossings());
+    }
+
+    auto improveBest = [&](const Order &order, long cost) {
+        if (cost >= bestCost) {
+            return false;
+        }
+        bestCost = cost;
+        shared.offer(order, cost, island);
+        if (cost == lb) {
+            stop.cancel();
+        }
+        return true;
+    };
+
+    auto bestMember = [&]() {
+        return static_cast<int>(std::min_element(costs.begin(), costs.end()) -
+                                costs.begin());
+    };
+
+    // Fills the population with local optima of random orders.
+    auto fillPopulation = [&]() {
+        while (population.size() < populationSize && !stop.is_cancelled()) {
+            Order order(graph.size_free);
+            order.permute();
+            order.track_crossings(graph);
+            local_search(graph, order, localSearchParameter, stop);
+            improveBest(order, order.get_crossings());
+            costs.push_back(order.get_crossings());
+            population.push_back(std::move(order));
+        }
+    };
+
+    // Crowding: a child replaces the most similar member if it is better.
+    // A child that differs enough from all members replaces the worst one.
+    auto insert = [&](Order &child, long cost) {
+        int closest = 0;
+        long closestDistance = std::numeric_limits<long>::max();
+        for (int i = 0; i < population.size(); ++i) {
+            long distance = footrule_distance(child, population[i]);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closest = i;
+            }
+        }
+        if (closestDistance == 0) {
+            return;
+        }
+
+        int replace = closest;
+        if (closestDistance >= minimumDistance) {
+            replace = static_cast<int>(
+                std::max_element(costs.begin(), costs.end()) - costs.begin());
+        }
+        if (cost < costs[replace] ||
+            (cost == costs[replace] && replace == closest)) {
+            population[replace] = std::move(child);
+            costs[replace] = cost;
+        }
+    };
+
+    auto tournament = [&]() {
+        int a = rng.next_below(population.size());
+        int b = rng.next_below(population.size());
+        return costs[a] <= costs[b] ? a : b;
+    };
+
+    fillPopulation();
+
+    int number_of_iterations = 0;
+    int generations_without_improvement = 0;
+    while (has_time_left(number_of_iterations) && !stop.is_cancelled() &&
+           population.size() >= 2) {
+        if (number_of_iterations %
+                geneticHeuristicParameter.migrationInterval ==
+            0) {
+            Order migrant(0);
+            long cost;
+            int worst = static_cast<int>(
+                std::max_element(costs.begin(), costs.end()) - costs.begin());
+            if (shared.migrate(island, seenVersion, costs[worst], migrant,
+                               cost)) {
+                migrant.track_crossings(graph);
+                bestCost = std::min(bestCost, cost);
+                insert(migrant, cost);
+            }
+        }
+
+        int first = tournament();
+        int second = tournament();
+        while (second == first) {
+            second = rng.next_below(population.size());
+        }
+
+        Order child = crossover(population[first], population[second],
+                                geneticHeuristicParameter.crossoverType, rng);
+        child.track_crossings(graph);
+        local_search(graph, child, localSearchParameter, stop);
+        long cost = child.get_crossings();
+
+        if (improveBest(child, cost)) {
+            generations_without_improvement = 0;
+        } else {
+            generations_without_improvement++;
+        }
+        insert(child, cost);
+
+        if (generations_without_improvement >
+            geneticHeuristicParameter.populationRestartAfter) {
+            // Keep only the best member and start over with new local optima.
+            int best = bestMember();
+            std::swap(population[0], population[best]);
+            std::swap(costs[0], costs[best]);
+            population.erase(population.begin() + 1, population.end());
+            costs.erase(costs.begin() + 1, costs.end());
+            fillPopulation();
+            generations_without_improvement = 0;
+        }
+
+        number_of_iterations++;
+    }
+
+    return number_of_iterations;
+}
+
+int GeneticHeuristic::runIteratedLocalSearchIsland(
+    PaceGraph &graph, SharedBest &shared, int island, long lb,
+    const CancellationToken &stop) {
+    LocalSearchParameter localSearchParameter;
+    localSearchParameter.siftingType =
+        geneticHeuristicParameter.siftingTypeImprovementSearch;
+    localSearchParameter.siftingInsertionType =
+        geneticHeuristicParameter.siftingInsertionTypeImprovementSearch;
+    localSearchParameter.worklistSifting = true;
+    SiftingBandit bandit;
+    if (geneticHeuristicParameter.adaptiveSifting) {
+        localSearchParameter.bandit = &bandit;
+    }
+
+    auto &rng = thread_rng();
+    const int minStrength =
+        std::max(1, geneticHeuristicParameter.ilsMinStrength);
+    const int maxStrength = std::max(minStrength, graph.size_free / 4);
+
+    Order current(graph.size_free);
+    long bestCost;
+    int seenVersion;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        current = Order(shared.position_to_vertex);
+        bestCost = shared.cost;
+        seenVersion = shared.version;
+    }
+    current.track_crossings(graph);
+    long currentCost = bestCost;
+
+    auto accept = [&](long cost) {
+        switch (geneticHeuristicParameter.ilsAcceptance) {
+        case IlsAcceptance::Better:
+            return cost < currentCost;
+        case IlsAcceptance::NotWorse:
+            return cost <= currentCost;
+        case IlsAcceptance::Threshold:
+            return cost <= currentCost ||
+                   cost <= (1 + geneticHeuristicParameter
+                                    .ilsAcceptanceThreshold) *
+                               bestCost;
+        default:
+            return true;
+        }
+    };
+
+    int strength = minStrength;
+    int improvementsInWindow = 0;
+    int number_of_iterations = 0;
+    while (has_time_left(number_of_iterations) && !stop.is_cancelled()) {
+        if (number_of_iterations %
+                geneticHeuristicParameter.migrationInterval ==
+            0) {
+            Order migrant(0);
+            long cost;
+            if (shared.migrate(island, seenVersion, currentCost, migrant,
+                               cost)) {
+                migrant.track_crossings(graph);
+                current = migrant;
+                currentCost = cost;
+                bestCost = std::min(bestCost, cost);
+            }
+        }
+
+        Order candidate = current;
+        std::vector<int> changedVertices =
+            perturb(candidate, geneticHeuristicParameter.perturbationType,
+                    strength, geneticHeuristicParameter.ilsMaxInsertionDistance,
+                    rng);
+        local_search(graph, candidate, localSearchParameter, stop,
+                     changedVertices);
+        long cost = candidate.get_crossings();
+
+        if (cost < currentCost) {
+            improvementsInWindow++;
+        }
+        if (accept(cost)) {
+            current = std::move(candidate);
+            currentCost = cost;
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            shared.offer(current, cost, island);
+            if (cost == lb) {
+                stop.cancel();
+            }
+        }
+
+        number_of_iterations++;
+        if (number_of_iterations %
+                geneticHeuristicParameter.ilsAdaptationWindow ==
+            0) {
+            double rate = static_cast<double>(improvementsInWindow) /
+                          geneticHeuristicParameter.ilsAdaptationWindow;
+            if (rate < geneticHeuristicParameter.ilsTargetImprovementRate) {
+                strength = std::min(maxStrength, strength * 3 / 2 + 1);
+            } else {
+                strength = std::max(minStrength, strength * 2 / 3);
+            }
+            improvementsInWindow = 0;
+        }
+    }
 
-    return bestOrder;
+    return number_of_iterations;
 }
@@ -3,16 +3,85 @@
 
 #include <utility>
 
+#include "../pace_graph/config.hpp"
 #include "../pace_graph/order.hpp"
+#include "crossover.hpp"
 #include "heuristic.hpp"
 #include "local_search.hpp"
+#include "perturbation.hpp"
+#include "portfolio.hpp"
+#include "tabu_search.hpp"
+
+enum class StallEngine {
+    /** Forces swaps of vertices at growing distances. */
+    ForcedSwaps,
+    /** Runs a time boxed tabu search (see tabu_search). */
+    TabuSearch
+};
+
+enum class GeneticMode {
+    /** Random restarts, see StallEngine for when they stop improving. */
+    Restarts,
+    /** A population of local optima that is recombined with crossovers. */
+    Population,
+    /**
+     * Iterated local search: perturbs the current order slightly and
+     * re-optimizes only around the perturbation.
+     */
+    IteratedLocalSearch
+};
+
+enum class IlsAcceptance {
+    /** Continue with the perturbed order only if it is better. */
+    Better,
+    /** Also continue if it is as good, i.e. walk on plateaus. */
+    NotWorse,
+    /**
+     * Also continue if it is at most ilsAcceptanceThreshold * cost worse
+     * than the best order of the island.
+     */
+    Threshold,
+    /** Always continue with the perturbed order (random walk). */
+    Always
+};
 
 class GeneticHeuristicParameter {
   public:
+    GeneticMode mode = GeneticMode::Restarts;
+
+    /**
+     * Constructs the start orders. The best one is the start of all islands,
+     * GeneticMode::Population adds the others to its population.
+     */
+    PortfolioParameter portfolioParameter;
+
     int forceMoveAllDirectNodesAfterIterationWithNoImprovement = 592;
     int numberOfForceSwapPositions = 90;
     int numberOfForceSwapStepSize = 9;
 
+    /**
+     * What improves the order of the restart loop when the restarts stopped
+     * improving it.
+     */
+    StallEngine stallEngine = StallEngine::ForcedSwaps;
+    int tabuSearchTimeLimitMs = 1000;
+    TabuSearchParameter tabuSearchParameter;
+
+    /**
+     * Number of local optima of the restarts that an island keeps for path
+     * relinking (see ElitePool). 0 disables path relinking.
+     */
+    int elitePoolSize = 10;
+    /**
+     * Orders of the pool differ in at least eliteMinimumDistance * n vertex
+     * pairs.
+     */
+    double eliteMinimumDistance = 1.0;
+    /** Restarts between two relinkings of random members of the pool. */
+    int pathRelinkingInterval = 16;
+    /** Local searches along a relinking path, see path_relinking. */
+    int pathRelinkingLocalSearches = 3;
+
     SiftingType siftingTypeInitialSearch = SiftingType::Random;
     SiftingInsertionType siftingInsertionTypeInitialSearch =
         SiftingInsertionType::Last;
@@ -20,17 +89,105 @@ class GeneticHeuristicParameter {
     SiftingType siftingTypeImprovementSearch = SiftingType::Random;
     SiftingInsertionType siftingInsertionTypeImprovementSearch =
         SiftingInsertionType::Last;
+    /**
+     * After a forced swap, only re-sift the vertices around the swap before
+     * verifying the local optimum (see LocalSearchParameter::worklistSifting).
+     */
+    bool worklistImprovementSearch = true;
+    /**
+     * Let a SiftingBandit per island and phase choose the sifting types
+     * online, instead of the fixed ones above.
+     */
+    bool adaptiveSifting = false;
+
+    /**
+     * Number of islands, i.e. searches that run on their own thread and share
+     * their best order. 0 uses one island per available thread (see
+     * available_threads()).
+     */
+    int numberOfIslands = 0;
+    /** Iterations of an island between looking at the orders of the others. */
+    int migrationInterval = 16;
+
+    /** Number of orders per island in GeneticMode::Population. */
+    int populationSize = 16;
+    CrossoverType crossoverType = CrossoverType::Random;
+    /**
+     * A child whose footrule distance to a member of the population is below
+     * minimumDistance * n may only replace that member, which keeps the
+     * population diverse.
+     */
+    double minimumDistance = 2.0;
+    /**
+     * Generations without improving the best order of the island, after which
+     * all other members of the population are replaced by new local optima.
+     */
+    int populationRestartAfter = 300;
+
+    /** How GeneticMode::IteratedLocalSearch perturbs the current order. */
+    PerturbationType perturbationType = PerturbationType::Random;
+    /** Maximal distance of a perturbing insertion. */
+    int ilsMaxInsertionDistance = 32;
+    IlsAcceptance ilsAcceptance = IlsAcceptance::NotWorse;
+    double ilsAcceptanceThreshold = 0.0005;
+    /**
+     * The strength of the perturbation adapts between ilsMinStrength and
+     * n / 4: after every ilsAdaptationWindow iterations it grows if fewer
+     * than ilsTargetImprovementRate of them improved the current order and
+     * shrinks otherwise.
+     */
+    int ilsMinStrength = 2;
+    int ilsAdaptationWindow = 32;
+    double ilsTargetImprovementRate = 0.05;
+
+    /**
+     * Overrides the fields that are given in config as "genetic.<field>"
+     * (and "tabu.<field>" for tabuSearchParameter, "portfolio.<field>" for
+     * portfolioParameter).
+     */
+    void load(const Config &config);
 };
 
+/**
+ * Repeatedly runs local search from random orders and forces swaps on the
+ * best order found when the restarts stop improving. The best local optima
+ * are kept in an elite pool and recombined with path relinking. See
+ * GeneticMode for the alternatives to the restarts. With several islands, the
+ * has_time_left callback is called from all of their threads.
+ */
 class GeneticHeuristic : public Heuristic {
+  private:
+    struct SharedBest;
+
+    /** The locally optimized start orders, the best one first. */
+    std::vector<Order> initialOrders;
+
+    /**
+     * Runs one island on graph, which is either the input graph (single
+     * island) or a constraint overlay of it. Stops when stop is cancelled.
+     * @return the number of iterations
+     */
+    int runIsland(PaceGraph &graph, SharedBest &shared, int island, long lb,
+                  const CancellationToken &stop);
+
+    /** Like runIsland, for GeneticMode::Population. */
+    int runPopulationIsland(PaceGraph &graph, SharedBest &shared, int island,
+                            long lb, const CancellationToken &stop);
+
+    /** Like runIsland, for GeneticMode::IteratedLocalSearch. */
+    int runIteratedLocalSearchIsland(PaceGraph &graph, SharedBest &shared,
+                                     int island, long lb,
+                                     const CancellationToken &stop);
+
   public:
     GeneticHeuristicParameter geneticHeuristicParameter;
 
     explicit
     GeneticHeuristic(std::function<bool(int)> has_time_left,
-                     GeneticHeuristicParameter geneticHeuristicParameter)
+                     GeneticHeuristicParameter geneticHeuristicParameter,
+                     CancellationToken cancellation = CancellationToken())
         : geneticHeuristicParameter(geneticHeuristicParameter),
-          Heuristic(std::move(has_time_left)) {}
+          Heuristic(std::move(has_time_left), std::move(cancellation)) {}
     Order solve(PaceGraph &graph) override;
 };
 
@@ -1,71 +1,75 @@
-#include <random>
-#include <unordered_set>
+#include <algorithm>
+#include <climits>
 
+#include "../pace_graph/crossing_kernels.hpp"
 #include "../pace_graph/order.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
 #include "greedy_insert_solver.hpp"
 
-int findBestInsertPosition(PaceGraph &graph, std::vector<int> &current_order,
-                           int random_element) {
-    // find best position in existing order
-    int best_position = 0;
-    long least_crossings = 0;
-    long number_of_crossing_left = 0;
-    long number_of_crossing_right = 0;
-
-    const auto size = current_order.size();
-    for (int i = 1; i <= size; ++i) {
-
-        auto [left, right] = graph.calculatingCrossingNumber(
-            current_order[i - 1], random_element);
-
-        number_of_crossing_left += left;
-        number_of_crossing_right -= right;
-
-        if (number_of_crossing_right + number_of_crossing_left <
-            least_crossings) {
-            best_position = i;
-            least_crossings =
-                number_of_crossing_right + number_of_crossing_left;
+namespace {
+
+/** Minimal number of positions one thread evaluates without the matrix. */
+constexpr int PARALLEL_GREEDY_MIN_CHUNK_SIZE = 2048;
+
+} // namespace
+
+int GreedyInsertSolver::findBestInsertPosition(PaceGraph &graph, int size,
+                                               int v) {
+    int barrier = INT_MAX;
+    if (graph.crossing.is_initialized()) {
+        // Moving v to the right past u changes the cost by
+        // c(u, v) - c(v, u) = -matrix_diff[v][u]. The barrier stops at
+        // vertices that have to stay right of v.
+        gather_row(graph.crossing.matrix_diff[v], order.data(), 1, size, -1,
+                   values.data());
+        barrier = FIXED / 2;
+    } else {
+        auto evaluate = [&](int from, int to, int) {
+            for (int i = from; i < to; ++i) {
+                auto [uv, vu] = graph.calculatingCrossingNumber(order[i], v);
+                values[i] = uv - vu;
+            }
+        };
+        if (parameter.parallelEvaluation) {
+            parallel_for(0, size, PARALLEL_GREEDY_MIN_CHUNK_SIZE, evaluate);
+        } else {
+            evaluate(0, size, 0);
         }
     }
-    return best_position;
+
+    // The cost change of position p is the prefix sum up to p - 1.
+    PrefixMinimum scan = prefix_minimum(values.data(), size, 0, barrier);
+    if (scan.occurrences > 0 && scan.minimum < 0) {
+        return scan.first + 1;
+    }
+    return 0;
 }
 
 Order GreedyInsertSolver::solve(PaceGraph &graph) {
-    std::vector<int> current_order;
-
     graph.init_crossing_matrix_if_necessary();
 
-    // initialize set with vertices not yet placed in the order
-    std::unordered_set<int> vertices_not_inserted;
-    const auto size = graph.size_free;
-    for (int i = 0; i < size; ++i) {
-        vertices_not_inserted.insert(i);
+    const int size = graph.size_free;
+    std::vector<int> vertices(size);
+    for (int v = 0; v < size; ++v) {
+        vertices[v] = v;
     }
-
-    // Seed the random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    // Generate a random index
-
-    while (!vertices_not_inserted.empty()) {
-        // std::cout << vertices_not_inserted.size() << std::endl;
-        std::uniform_int_distribution<> dis(0,
-                                            vertices_not_inserted.size() - 1);
-
-        // get randomly selected element
-        auto it = std::next(vertices_not_inserted.begin(), dis(gen));
-        int random_element = *it;
-
-        int best_position =
-            findBestInsertPosition(graph, current_order, random_element);
-
-        // insert vertex into order and remove from unordered set
-        current_order.insert(current_order.begin() + best_position,
-                             random_element);
-        vertices_not_inserted.erase(random_element);
+    std::shuffle(vertices.begin(), vertices.end(), thread_rng());
+
+    order.resize(size);
+    values.resize(size);
+    int inserted = 0;
+    for (; inserted < size && !cancellation.is_cancelled(); ++inserted) {
+        int v = vertices[inserted];
+        int position = findBestInsertPosition(graph, inserted, v);
+        std::copy_backward(order.begin() + position,
+                           order.begin() + inserted,
+                           order.begin() + inserted + 1);
+        order[position] = v;
     }
 
-    return Order(current_order);
+    // Keeps the order valid if cancelled.
+    std::copy(vertices.begin() + inserted, vertices.end(),
+              order.begin() + inserted);
+    return Order(order);
 }
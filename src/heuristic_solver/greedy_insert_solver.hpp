@@ -6,14 +6,42 @@
 #ifndef PACE2024_GREEDY_INSERT_SOLVER_H
 #define PACE2024_GREEDY_INSERT_SOLVER_H
 
-int findBestInsertPosition(PaceGraph &graph, std::vector<int> &current_order,
-                           int random_element);
+#include <vector>
 
+class GreedyInsertParameter {
+  public:
+    /**
+     * Evaluates the insertion positions on all threads. Only used without
+     * the crossing matrix, where the crossings of a pair take O(deg) time.
+     */
+    bool parallelEvaluation = true;
+};
+
+/**
+ * Inserts the vertices in random order, each at its best position. A
+ * position is evaluated with a prefix scan over the crossing matrix row of
+ * the vertex, gathered in the current order. Initializes the crossing matrix
+ * if it fits into memory. If it is cancelled, the vertices that are not
+ * inserted yet are appended.
+ */
 class GreedyInsertSolver : Heuristic {
+  private:
+    GreedyInsertParameter parameter;
+    /** The current order, only a prefix of it is filled. */
+    std::vector<int> order;
+    /** values[i] is the cost change of moving the vertex past order[i]. */
+    std::vector<int> values;
+
+    /** @return the best position for v among the first size vertices */
+    int findBestInsertPosition(PaceGraph &graph, int size, int v);
 
   public:
-    explicit GreedyInsertSolver(std::function<bool(int)> has_time_left)
-        : Heuristic(std::move(has_time_left)) {}
+    explicit GreedyInsertSolver(
+        std::function<bool(int)> has_time_left,
+        GreedyInsertParameter parameter = GreedyInsertParameter(),
+        CancellationToken cancellation = CancellationToken())
+        : Heuristic(std::move(has_time_left), std::move(cancellation)),
+          parameter(parameter) {}
 
     Order solve(PaceGraph &graph) override;
 };
@@ -5,16 +5,24 @@
 #ifndef PACE2024_HEURISTIC_HPP
 #define PACE2024_HEURISTIC_HPP
 
+#include "../pace_graph/cancellation.hpp"
 #include "../pace_graph/order.hpp"
 #include <functional>
 
 class Heuristic {
   protected:
+    /**
+     * Decides between iterations whether to continue. It may be expensive,
+     * inner loops check cancellation instead.
+     */
     std::function<bool(int)> has_time_left;
+    CancellationToken cancellation;
 
   public:
-    explicit Heuristic(std::function<bool(int)> has_time_left)
-        : has_time_left(std::move(has_time_left)) {}
+    explicit Heuristic(std::function<bool(int)> has_time_left,
+                       CancellationToken cancellation = CancellationToken())
+        : has_time_left(std::move(has_time_left)),
+          cancellation(std::move(cancellation)) {}
     virtual Order solve(PaceGraph &graph) = 0;
 };
 
@@ -1,157 +1,160 @@
 #include "heuristic_solver.hpp"
 #include "genetic_algorithm.hpp"
-#include "mean_position_heuristic.hpp"
-
-Order largeGraphHeuristic(PaceGraph &graph,
-                          const std::function<bool()> &has_time_left,
-                          const std::function<double()> &time_percentage_past) {
-    std::vector<int> positionOrder(graph.size_free);
-    const auto size = graph.size_free;
-    for (int i = 0; i < size; ++i) {
-        positionOrder[i] = i;
+#include "local_search.hpp"
+#include "portfolio.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * One round of the parallel mode: splits the order into segments that start
+ * at offset (and at 0), and sifts the vertices of every segment within it,
+ * each segment on its own thread. Vertices within the margin of a boundary
+ * are sifted afterwards on the whole order.
+ * @return true if a vertex was moved
+ */
+bool sift_segments(PaceGraph &graph, Order &order, int segmentLength,
+                   int offset, const LargeGraphParameter &parameter,
+                   long &largestFallback,
+                   const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+    std::vector<int> boundaries = {0};
+    for (int start = offset > 0 ? offset : segmentLength; start < size;
+         start += segmentLength) {
+        boundaries.push_back(start);
     }
-
-    MeanPositionParameter meanPositionParameter;
-    meanPositionParameter.meanType = average;
-
-    double start_time = time_percentage_past();
-
-    MeanPositionSolver meanPositionSolver1(
-        [start_time, time_percentage_past](int it) {
-            return it == 0 && time_percentage_past() < 0.1 + start_time;
-        },
-        meanPositionParameter);
-
-    Order o1 = meanPositionSolver1.solve(graph);
-    meanPositionParameter.meanType = median;
-    start_time = time_percentage_past();
-
-    MeanPositionSolver meanPositionSolver2(
-        [start_time, has_time_left, time_percentage_past](int it) {
-            return it == 0 && has_time_left() &&
-                   time_percentage_past() < 0.1 + start_time;
-        },
-        meanPositionParameter);
-
-    Order o2 = meanPositionSolver2.solve(graph);
-
-    long cost1 = o1.count_crossings(graph);
-    long cost2 = o2.count_crossings(graph);
-    std::cerr << "Cost1: " << cost1 << " Cost2: " << cost2 << std::endl;
-    Order bestOrder = cost1 < cost2 ? o1 : o2;
-
-    bool foundImprovement = true;
-
-    long largestFallback = 20000;
-    int largestMoveDistance = 2000;
-    while (foundImprovement) {
-        foundImprovement = false;
-        if (!has_time_left()) {
-            break;
-        }
-
-        std::shuffle(positionOrder.begin(), positionOrder.end(),
-                     std::mt19937(std::random_device()()));
-        const auto size = graph.size_free;
-        for (int i = 0; i < size; i++) {
-
-            if (!has_time_left()) {
-                break;
+    boundaries.push_back(size);
+    const int segments = boundaries.size() - 1;
+    const int margin = parameter.segmentMargin;
+
+    auto &rng = thread_rng();
+    std::vector<Xoshiro256> generators;
+    generators.reserve(segments);
+    for (int i = 0; i < segments; ++i) {
+        generators.emplace_back(rng());
+    }
+    std::vector<char> improved(segments, false);
+    std::vector<long> fallbacks(segments, largestFallback);
+
+    // Segments only move vertices between their own positions, so they
+    // write to disjoint parts of the order.
+    parallel_for(0, segments, 1, [&](int first, int last, int) {
+        for (int i = first; i < last; ++i) {
+            int from = boundaries[i];
+            int to = boundaries[i + 1];
+            int innerFrom = i == 0 ? from : from + margin;
+            int innerTo = i == segments - 1 ? to : to - margin;
+
+            std::vector<int> vertices;
+            for (int pos = innerFrom; pos < innerTo; ++pos) {
+                vertices.push_back(order.get_vertex(pos));
             }
-
-            int v = positionOrder[i];
-            int posOfV = bestOrder.get_position(v);
-
-            int bestCostChange = 0;
-            int bestPos = posOfV;
-            int currentCostChange = 0;
-            bool foundBestPos = true;
-            long currentFallback = 0;
-
-            double percentage_left = time_percentage_past();
-            bool isInEndPhase = percentage_left >= 0.9;
-            for (int pos = posOfV - 1;
-                 pos >= std::max(0, posOfV - largestMoveDistance); pos--) {
-                if ((isInEndPhase && !has_time_left()) ||
-                    (!isInEndPhase && pos % 100 == 0 && !has_time_left())) {
-                    foundBestPos = false;
+            std::shuffle(vertices.begin(), vertices.end(), generators[i]);
+            for (int v : vertices) {
+                if (cancellation.is_cancelled()) {
                     break;
                 }
-                int u = bestOrder.get_vertex(pos);
-
-                auto [u_v, v_u] = graph.calculatingCrossingNumber(u, v);
-                int crossingDiff = v_u - u_v;
-                currentCostChange += crossingDiff;
-
-                if (currentCostChange >= largestFallback) {
-                    break;
-                }
-
-                if (currentFallback < currentCostChange) {
-                    currentFallback = currentCostChange;
-                }
-
-                if (currentCostChange <= 0) {
-                    if (2 * currentFallback > largestFallback) {
-                        largestFallback = 2 * currentFallback;
-                        std::cerr << "Increase Fallback: " << largestFallback
-                                  << std::endl;
-                    }
-                }
-
-                if (currentCostChange < bestCostChange) {
-                    foundImprovement = true;
-                    bestCostChange = currentCostChange;
-                    bestPos = pos;
+                if (sift_vertex(graph, order, v, from, to,
+                                parameter.maxMoveDistance, fallbacks[i],
+                                cancellation)) {
+                    improved[i] = true;
                 }
             }
+        }
+    });
+
+    bool foundImprovement =
+        std::find(improved.begin(), improved.end(), true) != improved.end();
+    largestFallback = *std::max_element(fallbacks.begin(), fallbacks.end());
+
+    // Reconciles the boundaries.
+    std::vector<int> boundaryVertices;
+    for (int i = 1; i < segments; ++i) {
+        int from = std::max(boundaries[i - 1], boundaries[i] - margin);
+        int to = std::min(boundaries[i + 1], boundaries[i] + margin);
+        for (int pos = from; pos < to; ++pos) {
+            boundaryVertices.push_back(order.get_vertex(pos));
+        }
+    }
+    std::shuffle(boundaryVertices.begin(), boundaryVertices.end(), rng);
+    for (int v : boundaryVertices) {
+        if (cancellation.is_cancelled()) {
+            break;
+        }
+        if (sift_vertex(graph, order, v, 0, size, parameter.maxMoveDistance,
+                        largestFallback, cancellation)) {
+            foundImprovement = true;
+        }
+    }
+    return foundImprovement;
+}
 
-            currentCostChange = 0;
-            currentFallback = 0;
+} // namespace
 
-            for (int pos = posOfV + 1;
-                 pos < std::min(graph.size_free, posOfV + largestMoveDistance);
-                 pos++) {
+void LargeGraphParameter::load(const Config &config) {
+    config.load("large.maxMoveDistance", maxMoveDistance);
+    config.load("large.parallelSegments", parallelSegments);
+    config.load("large.minSegmentLength", minSegmentLength);
+    config.load("large.segmentMargin", segmentMargin);
+}
 
-                if ((isInEndPhase && percentage_left >= 0.9 &&
-                     !has_time_left()) ||
-                    (!isInEndPhase && pos % 100 == 0 && !has_time_left())) {
-                    foundBestPos = false;
-                    break;
-                }
+Order largeGraphHeuristic(PaceGraph &graph,
+                          const CancellationToken &cancellation,
+                          const CancellationToken &initialCancellation,
+                          const LargeGraphParameter &parameter) {
+    const auto size = graph.size_free;
 
-                int u = bestOrder.get_vertex(pos);
+    PortfolioParameter portfolioParameter;
+    portfolioParameter.load(solver_config());
+    Order bestOrder =
+        initial_orders(graph, portfolioParameter, initialCancellation)
+            .front();
 
-                auto [u_v, v_u] = graph.calculatingCrossingNumber(u, v);
-                int crossingDiff = -v_u + u_v;
-                currentCostChange += crossingDiff;
+    const int segments =
+        std::min(available_threads(),
+                 size / std::max(1, parameter.minSegmentLength));
+    const bool parallel = parameter.parallelSegments && segments > 1;
+    const int segmentLength = (size + segments - 1) / std::max(1, segments);
 
-                if (currentCostChange >= largestFallback) {
-                    break;
-                }
+    std::vector<int> positionOrder(size);
+    for (int i = 0; i < size; ++i) {
+        positionOrder[i] = i;
+    }
 
-                if (currentFallback < currentCostChange) {
-                    currentFallback = currentCostChange;
-                }
+    long largestFallback = 20000;
+    bool foundImprovement = true;
+    for (int round = 0; foundImprovement && !cancellation.is_cancelled();
+         ++round) {
+        long previousFallback = largestFallback;
+        foundImprovement = false;
 
-                if (currentCostChange <= 0) {
-                    if (2 * currentFallback > largestFallback) {
-                        largestFallback = 2 * currentFallback;
-                        std::cerr << "Increase Fallback: " << largestFallback
-                                  << std::endl;
-                    }
+        if (parallel) {
+            // Alternating offsets let vertices cross the boundaries.
+            int offset = round % 2 == 0 ? 0 : segmentLength / 2;
+            foundImprovement =
+                sift_segments(graph, bestOrder, segmentLength, offset,
+                              parameter, largestFallback, cancellation);
+        } else {
+            std::shuffle(positionOrder.begin(), positionOrder.end(),
+                         thread_rng());
+            for (int v : positionOrder) {
+                if (cancellation.is_cancelled()) {
+                    break;
                 }
-
-                if (currentCostChange < bestCostChange) {
-                    bestCostChange = currentCostChange;
-                    bestPos = pos;
+                if (sift_vertex(graph, bestOrder, v, 0, size,
+                                parameter.maxMoveDistance, largestFallback,
+                                cancellation)) {
                     foundImprovement = true;
                 }
             }
+        }
 
-            if (bestPos != posOfV && foundBestPos) {
-                bestOrder.move_vertex(v, bestPos);
-            }
+        if (largestFallback > previousFallback) {
+            std::cerr << "Increase Fallback: " << largestFallback
+                      << std::endl;
         }
     }
 
@@ -161,16 +164,23 @@ Order largeGraphHeuristic(PaceGraph &graph,
 Order HeuristicSolver::run(PaceGraph &graph) {
 
     bool canInitCrossingMatrix = graph.init_crossing_matrix_if_necessary();
+    if (canInitCrossingMatrix &&
+        engine == HeuristicEngine::SimulatedAnnealing) {
+        SimulatedAnnealing simulatedAnnealing(
+            [this](int it) { return this->has_time_left(); },
+            simulatedAnnealingParameter, cancellation(),
+            cancellation_after(simulatedAnnealingParameter.annealingTimeShare));
+        return simulatedAnnealing.solve(graph);
+    }
     if (canInitCrossingMatrix) {
-        GeneticHeuristicParameter geneticHeuristicParameter;
-
         GeneticHeuristic geneticHeuristic(
             [this](int it) { return this->has_time_left(); },
-            geneticHeuristicParameter);
+            geneticHeuristicParameter, cancellation());
         return geneticHeuristic.solve(graph);
     }
 
     return largeGraphHeuristic(
-        graph, [this]() { return this->has_time_left(); },
-        [this]() { return this->time_percentage_past(); });
+        graph, cancellation(),
+        cancellation_after(time_percentage_past() + 0.2),
+        largeGraphParameter);
 }
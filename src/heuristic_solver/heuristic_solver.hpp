@@ -6,10 +6,51 @@
 #include "../pace_graph/order.hpp"
 #include "../pace_graph/pace_graph.hpp"
 #include "../pace_graph/solver.hpp"
+#include "genetic_algorithm.hpp"
+#include "simulated_annealing.hpp"
 
-Order largeGraphHeuristic(PaceGraph &graph,
-                          const std::function<bool()> &has_time_left,
-                          const std::function<double()> &time_percentage_past);
+class LargeGraphParameter {
+  public:
+    /** Vertices move at most this many positions per step. */
+    int maxMoveDistance = 2000;
+
+    /**
+     * Splits the order into one segment per thread and sifts the vertices
+     * of the segments concurrently, each within its segment. The segments
+     * start at alternating offsets in every round, so that vertices can move
+     * past the boundaries. Only used if there are at least two segments of
+     * minSegmentLength vertices.
+     */
+    bool parallelSegments = true;
+    int minSegmentLength = 8192;
+    /**
+     * Vertices within this distance of a boundary are not sifted by the
+     * segments but afterwards on the whole order.
+     */
+    int segmentMargin = 500;
+
+    /** Overrides the fields that are given in config as "large.<field>". */
+    void load(const Config &config);
+};
+
+/**
+ * Heuristic for graphs whose crossing matrix does not fit into memory: the
+ * best initial order (see initial_orders) is improved by sifting with bounded
+ * move distances.
+ *
+ * @param initialCancellation stops the construction of the initial orders
+ */
+Order largeGraphHeuristic(
+    PaceGraph &graph, const CancellationToken &cancellation,
+    const CancellationToken &initialCancellation,
+    const LargeGraphParameter &parameter = LargeGraphParameter());
+
+enum class HeuristicEngine {
+    /** See GeneticHeuristic. */
+    Genetic,
+    /** See SimulatedAnnealing. */
+    SimulatedAnnealing
+};
 
 class HeuristicSolver : public SolutionSolver {
 
@@ -17,6 +58,12 @@ class HeuristicSolver : public SolutionSolver {
     Order run(PaceGraph &graph) override;
 
   public:
+    /** Engine used if the crossing matrix fits into memory. */
+    HeuristicEngine engine = HeuristicEngine::Genetic;
+    GeneticHeuristicParameter geneticHeuristicParameter;
+    SimulatedAnnealingParameter simulatedAnnealingParameter;
+    LargeGraphParameter largeGraphParameter;
+
     explicit HeuristicSolver(std::chrono::milliseconds limit =
                                  std::chrono::milliseconds(1000 * 60 * 5 -
                                                            1000 * 15))
@@ -1,9 +1,173 @@
 #include "local_search.hpp"
 
+#include "../pace_graph/crossing_kernels.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+#include "block_moves.hpp"
+
 #include <algorithm>
 #include <chrono>
-#include <functional>
-#include <random>
+#include <limits>
+
+namespace {
+
+/** Number of positions gathered at once while sifting. */
+constexpr int SIFTING_CHUNK_SIZE = 256;
+
+/**
+ * Number of vertices whose moves are computed at once. Larger batches have
+ * more conflicting moves that must be recomputed.
+ */
+constexpr int PARALLEL_SIFTING_BATCH_SIZE = 256;
+
+/**
+ * Number of batches sifted sequentially after a batch in which most moves
+ * conflicted.
+ */
+constexpr int PARALLEL_SIFTING_BACKOFF = 8;
+
+/** Minimal number of vertices in a batch handled by one thread. */
+constexpr int PARALLEL_SIFTING_MIN_CHUNK_SIZE = 16;
+
+/** Graphs with fewer vertices are always sifted sequentially. */
+constexpr int PARALLEL_SIFTING_MIN_SIZE = 1000;
+
+/** Lower bound for sift_direction that never stops a scan early. */
+constexpr long NO_BOUND = std::numeric_limits<long>::min() / 2;
+
+/** Cost change of a SiftingCandidate that accepts every position. */
+constexpr long ANY_MOVE = std::numeric_limits<long>::max() / 2;
+
+/** The best insertion position found so far while sifting a vertex. */
+struct SiftingCandidate {
+    long costChange = 0;
+    int position;
+    int foundWithThisCost = 1;
+};
+
+/**
+ * @return the index of the n-th (0-based) prefix sum of start + values that
+ * equals value. Such an index must exist.
+ */
+int nth_prefix_equal(const int *values, long start, long value, int n) {
+    long prefix = start;
+    for (int k = 0;; ++k) {
+        prefix += values[k];
+        if (prefix == value && n-- == 0) {
+            return k;
+        }
+    }
+}
+
+/**
+ * Scans the positions from, from + step, ... (count positions) for a better
+ * insertion position of the vertex whose diff row is given. For the
+ * scan to the left use step = -1 and sign = 1, to the right step = 1 and
+ * sign = -1.
+ *
+ * negativeBound is a lower bound for the sum of the negative (signed) entries
+ * of the positions to scan. The scan stops as soon as the remaining entries
+ * can not lead to a position at least as good as the best one.
+ *
+ * @return the sum of the positive (signed) entries that were scanned
+ */
+long sift_direction(const int *diff_row, const int *position_to_vertex,
+                    int from, int step, int count, int sign,
+                    long negativeBound, SiftingInsertionType insertionType,
+                    Xoshiro256 &rng, SiftingCandidate &best) {
+    thread_local std::vector<int> orderedRow(SIFTING_CHUNK_SIZE);
+
+    long crossingOld = 0;
+    long negativeScanned = 0;
+    for (int chunkStart = 0; chunkStart < count;
+         chunkStart += SIFTING_CHUNK_SIZE) {
+        // Positions with the same cost as the best one only matter if ties
+        // can replace the best position.
+        long lowestReachable = crossingOld + negativeBound - negativeScanned;
+        if (lowestReachable > best.costChange ||
+            (lowestReachable == best.costChange &&
+             insertionType == SiftingInsertionType::First)) {
+            break;
+        }
+
+        int chunkSize = std::min(SIFTING_CHUNK_SIZE, count - chunkStart);
+        gather_row(diff_row, position_to_vertex + from + chunkStart * step,
+                   step, chunkSize, sign, orderedRow.data());
+
+        PrefixMinimum scan = prefix_minimum(orderedRow.data(), chunkSize,
+                                            crossingOld, FIXED / 2);
+        if (scan.occurrences > 0 && scan.minimum <= best.costChange) {
+            auto position = [&](int k) {
+                return from + (chunkStart + k) * step;
+            };
+
+            bool improved = scan.minimum < best.costChange;
+            if (improved) {
+                best.costChange = scan.minimum;
+                best.foundWithThisCost = 0;
+            }
+
+            if (insertionType == SiftingInsertionType::Random) {
+                // Reservoir sampling over all positions with the best cost,
+                // a chunk is chosen with probability occurrences / found.
+                best.foundWithThisCost += scan.occurrences;
+                if (rng.next_below(best.foundWithThisCost) <
+                    scan.occurrences) {
+                    int k = nth_prefix_equal(orderedRow.data(), crossingOld,
+                                             scan.minimum,
+                                             rng.next_below(scan.occurrences));
+                    best.position = position(k);
+                }
+            } else if (insertionType == SiftingInsertionType::Last) {
+                best.position = position(scan.last);
+            } else if (improved) {
+                best.position = position(scan.first);
+            }
+        }
+
+        crossingOld = scan.total;
+        negativeScanned += scan.negativeTotal;
+        if (scan.scanned < chunkSize) {
+            break;
+        }
+    }
+
+    return crossingOld - negativeScanned;
+}
+
+/**
+ * Finds the best position to move v to, when every other vertex is fixed.
+ * Only reads the order, so it can be called concurrently for many vertices.
+ */
+SiftingCandidate find_sifting_move(const PaceGraph &graph, Order &order,
+                                   SiftingInsertionType insertionType, int v,
+                                   Xoshiro256 &rng) {
+    int posOfV = order.get_position(v);
+    const int *crossing_matrix_diff = graph.crossing.matrix_diff[v];
+    const int *position_to_vertex = order.position_to_vertex.data();
+
+    // The row is read in the random order of the vertices below. Prefetching
+    // it sequentially first lets the hardware stream it from memory.
+    for (int u = 0; u < graph.size_free; u += 16) {
+        __builtin_prefetch(crossing_matrix_diff + u);
+    }
+
+    SiftingCandidate best;
+    best.position = posOfV;
+
+    // The negative entries of the scan to the right are the positive entries
+    // of the row, except for those of the vertices to the left.
+    long positiveLeft = sift_direction(
+        crossing_matrix_diff, position_to_vertex, posOfV - 1, -1, posOfV, 1,
+        NO_BOUND, insertionType, rng, best);
+    sift_direction(crossing_matrix_diff, position_to_vertex, posOfV + 1, 1,
+                   graph.size_free - posOfV - 1, -1,
+                   positiveLeft - graph.crossing.get_positive_diff_sum(v),
+                   insertionType, rng, best);
+    return best;
+}
+
+} // namespace
 
 /**
  * This function is used to move a vertex v to the best position in the order,
@@ -13,105 +177,203 @@
  */
 long sifting_node(PaceGraph &graph, Order &order,
                   LocalSearchParameter &parameter, int v) {
+    SiftingCandidate best = find_sifting_move(
+        graph, order, parameter.siftingInsertionType, v, thread_rng());
+    order.move_vertex(v, best.position, best.costChange);
+    return best.costChange;
+}
+
+long best_insertion_move(const PaceGraph &graph, Order &order, int v,
+                         int &position) {
     int posOfV = order.get_position(v);
-    int bestPositionToInsert = posOfV;
-    long bestCostChange = 0;
+    const int *crossing_matrix_diff = graph.crossing.matrix_diff[v];
+    const int *position_to_vertex = order.position_to_vertex.data();
 
-    long crossingOld = 0;
-    auto crossing_matrix_diff = graph.crossing.matrix_diff[v];
+    // Starting with a cost change no position can reach makes the scans take
+    // the best position even if it is worse than staying.
+    SiftingCandidate best;
+    best.costChange = ANY_MOVE;
+    best.position = posOfV;
 
-    int foundWithThisCost = 1;
-    for (int i = posOfV - 1; i >= 0; i--) {
-        int u = order.get_vertex(i);
+    long positiveLeft = sift_direction(
+        crossing_matrix_diff, position_to_vertex, posOfV - 1, -1, posOfV, 1,
+        NO_BOUND, SiftingInsertionType::First, thread_rng(), best);
+    sift_direction(crossing_matrix_diff, position_to_vertex, posOfV + 1, 1,
+                   graph.size_free - posOfV - 1, -1,
+                   positiveLeft - graph.crossing.get_positive_diff_sum(v),
+                   SiftingInsertionType::First, thread_rng(), best);
 
-        int crossingDiff = crossing_matrix_diff[u];
+    position = best.position;
+    return best.position == posOfV ? 0 : best.costChange;
+}
 
-        if (crossingDiff >= FIXED / 2) {
-            break;
-        }
+/**
+ * Sifts the vertices in batches: the moves of a batch are computed in
+ * parallel against the order at the start of the batch and then applied in
+ * the order of the batch. A move is still exact if no move applied before it
+ * in the same batch touched a position between its start and its target,
+ * otherwise it is recomputed against the current order. The result only
+ * depends on the random seed, not on the number of threads.
+ *
+ * @return the improvement of the order
+ */
+long parallel_sifting(PaceGraph &graph, Order &order,
+                      LocalSearchParameter &parameter,
+                      const std::vector<int> &vertices,
+                      const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+    const int batchSize = PARALLEL_SIFTING_BATCH_SIZE;
+
+    std::vector<SiftingCandidate> moves(batchSize);
+    std::vector<char> touched(size, false);
+    std::vector<std::pair<int, int>> touchedRanges;
+    auto &rng = thread_rng();
 
-        crossingOld += crossingDiff;
+    // One team for the whole sweep, a batch takes too little time to start
+    // threads for it.
+    ThreadTeam team;
+
+    long improvement = 0;
+    int sequentialBatches = 0;
+    for (int batchStart = 0; batchStart < size && !cancellation.is_cancelled();
+         batchStart += batchSize) {
+        int batchEnd = std::min(size, batchStart + batchSize);
 
-        if (crossingOld <= bestCostChange) {
-            bool useSolution = false;
-            if (crossingOld == bestCostChange) {
-                if (parameter.siftingInsertionType ==
-                    SiftingInsertionType::Random) {
-                    foundWithThisCost++;
-                    if (rand() % foundWithThisCost == 0) {
-                        bestPositionToInsert = i;
+        // Every vertex gets its own random stream, so the moves do not
+        // depend on which thread computes them.
+        uint64_t batchSeed = rng();
+        bool speculate = sequentialBatches == 0;
+        if (speculate) {
+            team.parallel_for(
+                batchStart, batchEnd, PARALLEL_SIFTING_MIN_CHUNK_SIZE,
+                [&](int from, int to, int) {
+                    // Moves skipped here are never committed, the loop
+                    // below stops as well.
+                    for (int i = from; i < to && !cancellation.is_cancelled();
+                         ++i) {
+                        Xoshiro256 vertexRng(batchSeed + i);
+                        moves[i - batchStart] = find_sifting_move(
+                            graph, order, parameter.siftingInsertionType,
+                            vertices[i], vertexRng);
                     }
-                } else if (parameter.siftingInsertionType ==
-                           SiftingInsertionType::Last) {
-                    useSolution = true;
-                } else if (parameter.siftingInsertionType ==
-                           SiftingInsertionType::First) {
-                    useSolution = false;
-                }
-            } else {
-                foundWithThisCost = 1;
-                useSolution = true;
+                });
+        } else {
+            sequentialBatches--;
+        }
+
+        int conflicts = 0;
+        for (int i = batchStart; i < batchEnd && !cancellation.is_cancelled();
+             ++i) {
+            int v = vertices[i];
+            SiftingCandidate move = moves[i - batchStart];
+            int posOfV = order.get_position(v);
+            int low = std::min(posOfV, move.position);
+            int high = std::max(posOfV, move.position);
+
+            bool conflict = !speculate;
+            for (int p = low; p <= high && !conflict; ++p) {
+                conflict = touched[p];
+            }
+            if (conflict) {
+                conflicts++;
+                Xoshiro256 vertexRng(batchSeed + i);
+                move = find_sifting_move(graph, order,
+                                         parameter.siftingInsertionType, v,
+                                         vertexRng);
+                low = std::min(posOfV, move.position);
+                high = std::max(posOfV, move.position);
             }
 
-            if (useSolution) {
-                bestCostChange = crossingOld;
-                bestPositionToInsert = i;
+            if (move.position == posOfV) {
+                continue;
             }
+            order.move_vertex(v, move.position, move.costChange);
+            improvement += move.costChange;
+
+            if (speculate) {
+                std::fill(touched.begin() + low, touched.begin() + high + 1,
+                          true);
+                touchedRanges.emplace_back(low, high);
+            }
+        }
+
+        for (auto [low, high] : touchedRanges) {
+            std::fill(touched.begin() + low, touched.begin() + high + 1, false);
+        }
+        touchedRanges.clear();
+
+        // Far from a local optimum most moves are long and conflict, the
+        // speculative work is wasted then.
+        if (speculate && 2 * conflicts > batchEnd - batchStart) {
+            sequentialBatches = PARALLEL_SIFTING_BACKOFF;
         }
     }
 
-    crossingOld = 0;
-    const int graphSize = graph.size_free;
-    for (int i = posOfV + 1; i < graphSize; ++i) {
-        int u = order.get_vertex(i);
+    return improvement;
+}
 
-        int crossingDiff = -crossing_matrix_diff[u];
-        if (crossingDiff >= FIXED / 2) {
-            break;
+/**
+ * Sifts the given vertices in this order and afterwards only the vertices
+ * whose surroundings changed: after an improving move of v, v itself, the
+ * vertices it jumped over and the vertices next to its old and new position
+ * are queued again. Stops when the queue is empty.
+ *
+ * @return the improvement of the order
+ */
+long worklist_sifting(PaceGraph &graph, Order &order,
+                      LocalSearchParameter &parameter,
+                      const std::vector<int> &vertices,
+                      const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+
+    // Ring buffer, every vertex is in the queue at most once.
+    std::vector<int> queue(size);
+    std::vector<char> queued(size, false);
+    int head = 0;
+    int queueSize = 0;
+    auto push = [&](int u) {
+        if (!queued[u]) {
+            queued[u] = true;
+            queue[(head + queueSize) % size] = u;
+            queueSize++;
         }
+    };
+    for (int v : vertices) {
+        push(v);
+    }
 
-        crossingOld += crossingDiff;
+    long improvement = 0;
+    while (queueSize > 0 && !cancellation.is_cancelled()) {
 
-        if (crossingOld <= bestCostChange) {
+        int v = queue[head];
+        head = (head + 1) % size;
+        queueSize--;
+        queued[v] = false;
 
-            bool useSolution = false;
-            if (crossingOld == bestCostChange) {
-                if (parameter.siftingInsertionType ==
-                    SiftingInsertionType::Random) {
-                    foundWithThisCost++;
-                    if (rand() % foundWithThisCost == 0) {
-                        bestPositionToInsert = i;
-                    }
-                } else if (parameter.siftingInsertionType ==
-                           SiftingInsertionType::Last) {
-                    useSolution = true;
-                } else if (parameter.siftingInsertionType ==
-                           SiftingInsertionType::First) {
-                    useSolution = false;
-                }
-            } else {
-                foundWithThisCost = 1;
-                useSolution = true;
-            }
+        int oldPosition = order.get_position(v);
+        long costChange = sifting_node(graph, order, parameter, v);
+        if (costChange == 0) {
+            continue;
+        }
+        improvement += costChange;
 
-            if (useSolution) {
-                bestCostChange = crossingOld;
-                bestPositionToInsert = i;
-            }
+        int newPosition = order.get_position(v);
+        int low = std::max(0, std::min(oldPosition, newPosition) - 1);
+        int high = std::min(size - 1, std::max(oldPosition, newPosition) + 1);
+        for (int position = low; position <= high; ++position) {
+            push(order.get_vertex(position));
         }
     }
 
-    order.move_vertex(v, bestPositionToInsert);
-    return bestCostChange;
+    return improvement;
 }
 
 long sifting(PaceGraph &graph, Order &order, LocalSearchParameter &parameter,
-             std::vector<int> &position_array) {
+             std::vector<int> &position_array,
+             const CancellationToken &cancellation) {
     if (parameter.siftingType == SiftingType::Random) {
-        unsigned seed =
-            std::chrono::system_clock::now().time_since_epoch().count();
         std::shuffle(position_array.begin(), position_array.end(),
-                     std::default_random_engine(seed));
+                     thread_rng());
     } else if (parameter.siftingType == SiftingType::DegreeOrder) {
         std::sort(position_array.begin(), position_array.end(),
                   [&graph](int u, int v) {
@@ -126,17 +388,61 @@ long sifting(PaceGraph &graph, Order &order, LocalSearchParameter &parameter,
                   });
     }
 
+    if (parameter.worklistSifting && parameter.exhaustiveSifting) {
+        return worklist_sifting(graph, order, parameter, position_array,
+                                cancellation);
+    }
+
+    if (parameter.parallelSifting && available_threads() > 1 &&
+        graph.size_free >= PARALLEL_SIFTING_MIN_SIZE) {
+        return parallel_sifting(graph, order, parameter, position_array,
+                                cancellation);
+    }
+
     long improvement = 0;
     const auto size = graph.size_free;
-    for (int v = 0; v < size; v++) {
+    for (int v = 0; v < size && !cancellation.is_cancelled(); v++) {
         improvement += sifting_node(graph, order, parameter, position_array[v]);
     }
     return improvement;
 }
 
-long local_search(PaceGraph &graph, Order &order,
-                  LocalSearchParameter &parameter,
-                  const std::function<bool()> &has_time_left) {
+namespace {
+
+/**
+ * Lets parameter.bandit (if any) choose the sifting strategy of a local
+ * search and reports the result back.
+ */
+class BanditPull {
+  private:
+    LocalSearchParameter &parameter;
+    int arm = -1;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+    explicit BanditPull(LocalSearchParameter &parameter)
+        : parameter(parameter) {
+        if (parameter.bandit != nullptr) {
+            arm = parameter.bandit->select();
+            parameter.siftingType = (*parameter.bandit)[arm].siftingType;
+            parameter.siftingInsertionType =
+                (*parameter.bandit)[arm].siftingInsertionType;
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    void finish(long improvement) {
+        if (arm != -1) {
+            std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::steady_clock::now() - start;
+            parameter.bandit->update(arm, -improvement, elapsed.count());
+        }
+    }
+};
+
+long repeated_sifting(PaceGraph &graph, Order &order,
+                      LocalSearchParameter &parameter,
+                      const CancellationToken &cancellation) {
     long improvement = 0;
 
     std::vector<int> position_array;
@@ -146,8 +452,13 @@ long local_search(PaceGraph &graph, Order &order,
         position_array.push_back(i);
     }
 
-    while (has_time_left()) {
-        long i = sifting(graph, order, parameter, position_array);
+    while (!cancellation.is_cancelled()) {
+        long i =
+            sifting(graph, order, parameter, position_array, cancellation);
+        if (parameter.blockMoves && (i == 0 || !parameter.exhaustiveSifting)) {
+            i += block_moves(graph, order, parameter.blockMoveMaxSpan,
+                             cancellation);
+        }
         improvement += i;
 
         if (!parameter.exhaustiveSifting || i == 0) {
@@ -156,4 +467,99 @@ long local_search(PaceGraph &graph, Order &order,
     }
 
     return improvement;
-}
\ No newline at end of file
+}
+
+} // namespace
+
+long local_search(PaceGraph &graph, Order &order,
+                  LocalSearchParameter &parameter,
+                  const CancellationToken &cancellation,
+                  const std::vector<int> &changedVertices) {
+    BanditPull pull(parameter);
+    long improvement = 0;
+    if (parameter.worklistSifting && parameter.exhaustiveSifting &&
+        !cancellation.is_cancelled()) {
+        improvement += worklist_sifting(graph, order, parameter,
+                                        changedVertices, cancellation);
+    }
+    improvement += repeated_sifting(graph, order, parameter, cancellation);
+    pull.finish(improvement);
+    return improvement;
+}
+
+long local_search(PaceGraph &graph, Order &order,
+                  LocalSearchParameter &parameter,
+                  const CancellationToken &cancellation) {
+    BanditPull pull(parameter);
+    long improvement = repeated_sifting(graph, order, parameter, cancellation);
+    pull.finish(improvement);
+    return improvement;
+}
+
+bool sift_vertex(PaceGraph &graph, Order &order, int v, int from, int to,
+                 int maxDistance, long &largestFallback,
+                 const CancellationToken &cancellation) {
+    int posOfV = order.get_position(v);
+
+    long bestCostChange = 0;
+    int bestPos = posOfV;
+    long currentCostChange = 0;
+    long currentFallback = 0;
+
+    for (int pos = posOfV - 1; pos >= std::max(from, posOfV - maxDistance);
+         pos--) {
+        if (cancellation.is_cancelled()) {
+            return false;
+        }
+        int u = order.get_vertex(pos);
+
+        auto [u_v, v_u] = graph.calculatingCrossingNumber(u, v);
+        currentCostChange += v_u - u_v;
+
+        if (currentCostChange >= largestFallback) {
+            break;
+        }
+        currentFallback = std::max(currentFallback, currentCostChange);
+        if (currentCostChange <= 0) {
+            largestFallback = std::max(largestFallback, 2 * currentFallback);
+        }
+
+        if (currentCostChange < bestCostChange) {
+            bestCostChange = currentCostChange;
+            bestPos = pos;
+        }
+    }
+
+    currentCostChange = 0;
+    currentFallback = 0;
+
+    for (int pos = posOfV + 1; pos < std::min(to, posOfV + maxDistance);
+         pos++) {
+        if (cancellation.is_cancelled()) {
+            return false;
+        }
+        int u = order.get_vertex(pos);
+
+        auto [u_v, v_u] = graph.calculatingCrossingNumber(u, v);
+        currentCostChange += u_v - v_u;
+
+        if (currentCostChange >= largestFallback) {
+            break;
+        }
+        currentFallback = std::max(currentFallback, currentCostChange);
+        if (currentCostChange <= 0) {
+            largestFallback = std::max(largestFallback, 2 * currentFallback);
+        }
+
+        if (currentCostChange < bestCostChange) {
+            bestCostChange = currentCostChange;
+            bestPos = pos;
+        }
+    }
+
+    if (bestPos == posOfV) {
+        return false;
+    }
+    order.move_vertex(v, bestPos);
+    return true;
+}
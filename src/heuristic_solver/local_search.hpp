@@ -1,9 +1,10 @@
 #ifndef PACE2024_LOCAL_SEARCH_HPP
 #define PACE2024_LOCAL_SEARCH_HPP
 
+#include "../pace_graph/cancellation.hpp"
 #include "../pace_graph/order.hpp"
 #include "../pace_graph/pace_graph.hpp"
-#include <functional>
+#include "sifting_bandit.hpp"
 
 enum class SiftingType {
     None,
@@ -23,8 +24,43 @@ class LocalSearchParameter {
     SiftingType siftingType = SiftingType::Random;
     SiftingInsertionType siftingInsertionType = SiftingInsertionType::Random;
     bool exhaustiveSifting = true;
+    /**
+     * Compute the moves of a sweep on all threads (see available_threads()).
+     * Only used for large graphs and if more than one thread is available.
+     * Off until a multi-core timing shows that it beats sequential sifting.
+     */
+    bool parallelSifting = false;
+    /**
+     * With exhaustiveSifting, only sift vertices again whose surroundings in
+     * the order changed since they were sifted last, instead of sweeping over
+     * all vertices. A last sweep over all vertices verifies the local
+     * optimum. Always runs sequentially.
+     */
+    bool worklistSifting = false;
+    /**
+     * Once sifting is stuck, try to move whole blocks of vertices of up to
+     * blockMoveMaxSpan positions past each other (see block_moves).
+     */
+    bool blockMoves = false;
+    int blockMoveMaxSpan = 32;
+    /**
+     * If set, every local_search call lets the bandit choose siftingType and
+     * siftingInsertionType, and reports its improvement per microsecond
+     * back.
+     */
+    SiftingBandit *bandit = nullptr;
 };
 
+/**
+ * Finds the best position for v other than its current one, when every other
+ * vertex is fixed. Unlike sifting, the best move may make the order worse.
+ * Sets position to the current position of v if v can not move (because of
+ * constraints).
+ * @return the cost change of moving v to position
+ */
+long best_insertion_move(const PaceGraph &graph, Order &order, int v,
+                         int &position);
+
 /**
  * Tries to improve a given order by performing local search steps.
  * @param graph input graph
@@ -33,6 +69,28 @@ class LocalSearchParameter {
  */
 long local_search(PaceGraph &graph, Order &order,
                   LocalSearchParameter &parameter,
-                  const std::function<bool()> &has_time_left);
+                  const CancellationToken &cancellation);
+
+/**
+ * Like local_search, for an order that was a local optimum before the given
+ * vertices changed (moved or got new constraints). With worklistSifting only
+ * these vertices are sifted first, before the local optimum is verified.
+ */
+long local_search(PaceGraph &graph, Order &order,
+                  LocalSearchParameter &parameter,
+                  const CancellationToken &cancellation,
+                  const std::vector<int> &changedVertices);
+
+/**
+ * Sifting for graphs without crossing matrix: moves v to the best position in
+ * [from, to) that is at most maxDistance away, all other vertices keeping
+ * their relative order. A direction is scanned until the cost increased by
+ * largestFallback. largestFallback grows to twice the largest increase that a
+ * later position made up for.
+ * @return true if v was moved
+ */
+bool sift_vertex(PaceGraph &graph, Order &order, int v, int from, int to,
+                 int maxDistance, long &largestFallback,
+                 const CancellationToken &cancellation);
 
 #endif // PACE2024_LOCAL_SEARCH_HPP
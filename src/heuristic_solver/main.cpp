@@ -1,10 +1,49 @@
+#include "../pace_graph/arguments.hpp"
 #include "../pace_graph/order.hpp"
+#include "../pace_graph/parallel.hpp"
 #include "genetic_algorithm.hpp"
 #include "heuristic_solver.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
-int main() {
+int main(int argc, char *argv[]) {
+    apply_seed_argument(argc, argv);
+    apply_threads_argument(argc, argv);
+    apply_config_argument(argc, argv);
+
     HeuristicSolver solver;
+    solver.geneticHeuristicParameter.load(solver_config());
+    solver.simulatedAnnealingParameter.load(solver_config());
+    solver.largeGraphParameter.load(solver_config());
+    // "--genetic-mode population" recombines a population of local optima
+    // instead of restarting from random orders, "--genetic-mode ils"
+    // perturbs the best order instead.
+    const char *mode = get_argument(argc, argv, "--genetic-mode");
+    if (mode != nullptr && std::strcmp(mode, "population") == 0) {
+        solver.geneticHeuristicParameter.mode = GeneticMode::Population;
+    }
+    if (mode != nullptr && std::strcmp(mode, "ils") == 0) {
+        solver.geneticHeuristicParameter.mode =
+            GeneticMode::IteratedLocalSearch;
+    }
+    // "--stall-engine tabu" replaces the forced swaps by a tabu search.
+    const char *engine = get_argument(argc, argv, "--stall-engine");
+    if (engine != nullptr && std::strcmp(engine, "tabu") == 0) {
+        solver.geneticHeuristicParameter.stallEngine = StallEngine::TabuSearch;
+    }
+    // "--engine annealing" uses simulated annealing instead of the genetic
+    // heuristic, "--engine tempering" runs it as parallel tempering with one
+    // replica per thread (at least 4).
+    const char *heuristic = get_argument(argc, argv, "--engine");
+    if (heuristic != nullptr && (std::strcmp(heuristic, "annealing") == 0 ||
+                                 std::strcmp(heuristic, "tempering") == 0)) {
+        solver.engine = HeuristicEngine::SimulatedAnnealing;
+        if (std::strcmp(heuristic, "tempering") == 0) {
+            solver.simulatedAnnealingParameter.numberOfReplicas =
+                std::max(4, number_of_threads());
+        }
+    }
     PaceGraph graph = PaceGraph::from_gr(std::cin);
     solver.solve(graph);
     return 0;
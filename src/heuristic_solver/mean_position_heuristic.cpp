@@ -1,18 +1,70 @@
 #include "mean_position_heuristic.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+
+namespace {
+
+/** Graphs with fewer vertices compute their keys sequentially. */
+constexpr int PARALLEL_MEAN_POSITION_MIN_SIZE = 100000;
+
+/** Minimal number of vertices whose keys one thread computes. */
+constexpr int PARALLEL_MEAN_POSITION_MIN_CHUNK_SIZE = 16384;
+
+} // namespace
+
+void MeanPositionSolver::compute_keys(PaceGraph &graph,
+                                      const std::vector<double> &offset) {
+    const auto meanType = meanPositionParameter.meanType;
+    if (meanType == sum_along_crossing) {
+        graph.crossing_row_sums(rowSums);
+    }
+
+    auto compute = [&](int from, int to, int) {
+        for (int v = from; v < to; ++v) {
+            const auto &neighbors = graph.neighbors_free[v];
+            double key = 0;
+            if (meanType == average && !neighbors.empty()) {
+                long sum = 0;
+                for (int neighbor : neighbors) {
+                    sum += neighbor;
+                }
+                key = static_cast<double>(sum) / neighbors.size();
+                tieBreakKeys[v] = neighbors[neighbors.size() / 2] + offset[v];
+            } else if (meanType == average) {
+                tieBreakKeys[v] = 0;
+            } else if (meanType == median && !neighbors.empty()) {
+                key = neighbors[neighbors.size() / 2] + offset[v];
+            } else if (meanType == sum_along_crossing) {
+                key = rowSums[v];
+            }
+            keys[v] = key;
+        }
+    };
+
+    const int size = graph.size_free;
+    if (size >= PARALLEL_MEAN_POSITION_MIN_SIZE) {
+        parallel_for(0, size, PARALLEL_MEAN_POSITION_MIN_CHUNK_SIZE, compute);
+    } else {
+        compute(0, size, 0);
+    }
+}
 
 Order MeanPositionSolver::jittering(PaceGraph &graph, int iteration) {
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    auto &gen = thread_rng();
     std::uniform_real_distribution<> dis(-1.0, 1.0);
 
-    Order currentBestOrder = Order(graph.size_free);
-    long bestOrderCost = 1000000000000000000;
-
-    std::vector<double> nodeOffset = std::vector<double>(graph.size_free);
-    std::vector<std::tuple<int, double>> average_position(graph.size_free);
     const auto size = graph.size_free;
+    Order currentBestOrder = Order(size);
+    Order order = Order(size);
+    long bestOrderCost = 1000000000000000000;
 
+    nodeOffset.resize(size);
+    newNodeOffset.resize(size);
+    keys.resize(size);
+    if (meanPositionParameter.meanType == average) {
+        tieBreakKeys.resize(size);
+    }
     for (int i = 0; i < size; ++i) {
         if (meanPositionParameter.useJittering && iteration != 0) {
             nodeOffset[i] = dis(gen);
@@ -24,58 +76,28 @@ Order MeanPositionSolver::jittering(PaceGraph &graph, int iteration) {
     int jitterIterations =
         iteration == 0 ? 1 : meanPositionParameter.jitterIterations;
     for (int _ = 0; _ < jitterIterations; ++_) {
-        std::vector<double> newNodeOffset = std::vector<double>(nodeOffset);
         for (int j = 0; j < size; ++j) {
-            newNodeOffset[j] += dis(gen) / 10;
+            newNodeOffset[j] = nodeOffset[j] + dis(gen) / 10;
         }
 
-        for (int i = 0; i < size; ++i) {
-            auto neighbors_of_node = graph.neighbors_free[i];
-
-            double avg = 0;
-
-            switch (meanPositionParameter.meanType) {
-            case average:
-                for (auto neighbor : neighbors_of_node) {
-                    avg += neighbor;
-                }
-                avg /= neighbors_of_node.size();
-                break;
-            case median:
-                if (neighbors_of_node.size() != 0) {
-                    int position_middle_node = neighbors_of_node.size() / 2;
-                    avg = neighbors_of_node[position_middle_node] +
-                          newNodeOffset[i];
-                }
-                break;
-            case sum_along_crossing:
-                graph.init_crossing_matrix_if_necessary();
-                const auto &crossing_matrix_for_i = graph.crossing.matrix[i];
-                for (int j = 0; j < graph.size_free; ++j) {
-                    avg += crossing_matrix_for_i[j];
-                }
-            }
-            average_position[i] = std::tuple(i, avg);
+        compute_keys(graph, newNodeOffset);
+        if (meanPositionParameter.meanType == average) {
+            // Vertices with the same barycenter are common and their order
+            // matters a lot, e.g. for vertices of degree 1 and 3.
+            sorter.sort_indices(tieBreakKeys, order.position_to_vertex);
+            sorter.sort_by(keys, order.position_to_vertex);
+        } else {
+            sorter.sort_indices(keys, order.position_to_vertex);
         }
-
-        std::sort(average_position.begin(), average_position.end(),
-                  [](const std::tuple<int, double> &a,
-                     const std::tuple<int, double> &b) {
-                      // Compare based on the second element
-                      return std::get<1>(a) < std::get<1>(b);
-                  });
-
-        std::vector<int> orderVector(graph.size_free);
         for (int i = 0; i < size; ++i) {
-            orderVector[i] = std::get<0>(average_position[i]);
+            order.vertex_to_position[order.position_to_vertex[i]] = i;
         }
 
-        Order order = Order(orderVector);
         long cost = order.count_crossings(graph);
         if (cost <= bestOrderCost) {
             bestOrderCost = cost;
-            currentBestOrder = order;
-            nodeOffset = newNodeOffset;
+            std::swap(currentBestOrder, order);
+            std::swap(nodeOffset, newNodeOffset);
         }
 
         if (!meanPositionParameter.useJittering || !has_time_left(iteration)) {
@@ -90,11 +112,12 @@ void MeanPositionSolver::improveOrderWithSwapping(PaceGraph &graph,
                                                   Order &order, int iteration) {
     bool foundSwap = true;
 
-    while (foundSwap && has_time_left(iteration)) {
+    while (foundSwap && has_time_left(iteration) &&
+           !cancellation.is_cancelled()) {
         foundSwap = false;
 
         for (int i = 0; i < graph.size_free - 1; ++i) {
-            if (!has_time_left(iteration)) {
+            if (!has_time_left(iteration) || cancellation.is_cancelled()) {
                 break;
             }
             int u = order.get_vertex(i);
@@ -4,6 +4,7 @@
 
 #include "../pace_graph/order.hpp"
 #include "../pace_graph/pace_graph.hpp"
+#include "../pace_graph/radix_sort.hpp"
 #include "heuristic.hpp"
 
 enum MeanTypeAlgo { average, median, sum_along_crossing };
@@ -18,6 +19,20 @@ class MeanPositionParameter {
 
 class MeanPositionSolver : Heuristic {
   private:
+    // Buffers reused by all jittering iterations.
+    std::vector<double> nodeOffset;
+    std::vector<double> newNodeOffset;
+    std::vector<double> keys;
+    std::vector<double> tieBreakKeys;
+    std::vector<long> rowSums;
+    RadixSorter sorter;
+
+    /**
+     * Computes the key (mean position) of every vertex into keys. For the
+     * average, ties are broken by the jittered median in tieBreakKeys. Runs
+     * in parallel for large graphs.
+     */
+    void compute_keys(PaceGraph &graph, const std::vector<double> &offset);
     Order jittering(PaceGraph &graph, int iteration);
     void improveOrderWithSwapping(PaceGraph &graph, Order &order,
                                   int iteration);
@@ -25,9 +40,11 @@ class MeanPositionSolver : Heuristic {
   public:
     MeanPositionParameter meanPositionParameter;
 
-    explicit MeanPositionSolver(std::function<bool(int)> has_time_left,
-                                MeanPositionParameter meanPositionParameter)
-        : Heuristic(std::move(has_time_left)),
+    explicit MeanPositionSolver(
+        std::function<bool(int)> has_time_left,
+        MeanPositionParameter meanPositionParameter,
+        CancellationToken cancellation = CancellationToken())
+        : Heuristic(std::move(has_time_left), std::move(cancellation)),
           meanPositionParameter(meanPositionParameter) {}
 
     Order solve(PaceGraph &graph) override;
@@ -0,0 +1,38 @@
+#include "perturbation.hpp"
+
+#include <algorithm>
+
+std::vector<int> perturb(Order &order, PerturbationType type, int strength,
+                         int maxDistance, Xoshiro256 &rng) {
+    const int size = order.position_to_vertex.size();
+    std::vector<int> changedVertices;
+    if (size < 2) {
+        return changedVertices;
+    }
+    strength = std::min(strength, size);
+
+    if (type == PerturbationType::Random) {
+        type = static_cast<PerturbationType>(rng.next_below(2));
+    }
+
+    if (type == PerturbationType::Insertions) {
+        for (int i = 0; i < strength; ++i) {
+            int v = rng.next_below(size);
+            int position = order.get_position(v);
+            int from = std::max(0, position - maxDistance);
+            int to = std::min(size - 1, position + maxDistance);
+            order.move_vertex(v, from + rng.next_below(to - from + 1));
+            changedVertices.push_back(v);
+        }
+    } else {
+        int begin = rng.next_below(size - strength + 1);
+        // Fisher-Yates on the positions [begin, begin + strength).
+        for (int i = strength - 1; i > 0; --i) {
+            order.swap_by_position(begin + i, begin + rng.next_below(i + 1));
+        }
+        changedVertices.assign(order.position_to_vertex.begin() + begin,
+                               order.position_to_vertex.begin() + begin +
+                                   strength);
+    }
+    return changedVertices;
+}
@@ -0,0 +1,28 @@
+#ifndef PACE2024_PERTURBATION_HPP
+#define PACE2024_PERTURBATION_HPP
+
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/random.hpp"
+
+#include <vector>
+
+enum class PerturbationType {
+    /** strength random vertices move to random positions nearby. */
+    Insertions,
+    /** A random segment of strength positions is shuffled. */
+    SegmentShuffle,
+    /** One of the above, chosen uniformly at random for every perturbation. */
+    Random
+};
+
+/**
+ * Changes order randomly, keeping the tracked crossings up to date.
+ * @param strength number of moved vertices or length of the shuffled segment
+ * @param maxDistance maximal distance of an insertion
+ * @return the vertices that moved, to re-optimize them with a worklist
+ * local_search
+ */
+std::vector<int> perturb(Order &order, PerturbationType type, int strength,
+                         int maxDistance, Xoshiro256 &rng);
+
+#endif // PACE2024_PERTURBATION_HPP
@@ -0,0 +1,129 @@
+#include "portfolio.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+#include "greedy_insert_solver.hpp"
+#include "mean_position_heuristic.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+enum class InitialHeuristic { Cutwidth, Median, Barycenter, GreedyInsertion };
+
+const char *name(InitialHeuristic heuristic) {
+    switch (heuristic) {
+    case InitialHeuristic::Cutwidth:
+        return "cutwidth";
+    case InitialHeuristic::Median:
+        return "median";
+    case InitialHeuristic::Barycenter:
+        return "barycenter";
+    case InitialHeuristic::GreedyInsertion:
+        return "greedy insertion";
+    }
+    return "";
+}
+
+Order construct(PaceGraph &graph, InitialHeuristic heuristic,
+                const PortfolioParameter &parameter,
+                const CancellationToken &cancellation) {
+    // The mean positions are computed even if cancelled, only the swapping
+    // stops.
+    auto firstIteration = [](int it) { return it == 0; };
+
+    switch (heuristic) {
+    case InitialHeuristic::Cutwidth:
+        return Order(graph.cutwidth_order());
+    case InitialHeuristic::Median:
+    case InitialHeuristic::Barycenter: {
+        MeanPositionParameter meanPositionParameter;
+        meanPositionParameter.useJittering = false;
+        meanPositionParameter.useLocalSearch = parameter.useSwapping;
+        meanPositionParameter.meanType =
+            heuristic == InitialHeuristic::Median ? median : average;
+        MeanPositionSolver solver(firstIteration, meanPositionParameter,
+                                  cancellation);
+        return solver.solve(graph);
+    }
+    case InitialHeuristic::GreedyInsertion: {
+        GreedyInsertSolver solver(firstIteration, GreedyInsertParameter(),
+                                  cancellation);
+        return solver.solve(graph);
+    }
+    }
+    return Order(graph.size_free);
+}
+
+} // namespace
+
+void PortfolioParameter::load(const Config &config) {
+    config.load("portfolio.useBarycenter", useBarycenter);
+    config.load("portfolio.useMedian", useMedian);
+    config.load("portfolio.useGreedyInsertion", useGreedyInsertion);
+    config.load("portfolio.useCutwidthOrder", useCutwidthOrder);
+    config.load("portfolio.useSwapping", useSwapping);
+    config.load("portfolio.numberOfOrders", numberOfOrders);
+}
+
+std::vector<Order> initial_orders(PaceGraph &graph,
+                                  const PortfolioParameter &parameter,
+                                  const CancellationToken &cancellation) {
+    std::vector<InitialHeuristic> heuristics;
+    if (parameter.useCutwidthOrder && graph.cutwidth_positions != nullptr) {
+        heuristics.push_back(InitialHeuristic::Cutwidth);
+    }
+    if (parameter.useMedian) {
+        heuristics.push_back(InitialHeuristic::Median);
+    }
+    if (parameter.useBarycenter) {
+        heuristics.push_back(InitialHeuristic::Barycenter);
+    }
+    // Initializing the matrix here would race with the other heuristics.
+    if (parameter.useGreedyInsertion && graph.crossing.is_initialized()) {
+        heuristics.push_back(InitialHeuristic::GreedyInsertion);
+    }
+    if (heuristics.empty()) {
+        return {Order(graph.size_free)};
+    }
+
+    std::vector<Order> orders(heuristics.size(), Order(0));
+    std::vector<long> costs(heuristics.size());
+    std::vector<uint64_t> streams(heuristics.size());
+    for (auto &stream : streams) {
+        stream = thread_rng()();
+    }
+    // The heuristics only read the graph.
+    parallel_for(0, heuristics.size(), 1, [&](int from, int to, int) {
+        for (int i = from; i < to; ++i) {
+            ThreadRngScope rngScope(streams[i]);
+            orders[i] = construct(graph, heuristics[i], parameter,
+                                  cancellation);
+            costs[i] = orders[i].count_crossings(graph);
+        }
+    });
+
+    std::vector<int> ranking(heuristics.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(),
+                     [&](int a, int b) { return costs[a] < costs[b]; });
+    std::cerr << "# Initial order: " << name(heuristics[ranking[0]]) << " "
+              << costs[ranking[0]] << std::endl;
+
+    std::vector<Order> result;
+    for (int i : ranking) {
+        if (result.size() >= std::max(1, parameter.numberOfOrders)) {
+            break;
+        }
+        bool duplicate = std::any_of(
+            result.begin(), result.end(), [&](const Order &order) {
+                return order.position_to_vertex ==
+                       orders[i].position_to_vertex;
+            });
+        if (!duplicate) {
+            result.push_back(std::move(orders[i]));
+        }
+    }
+    return result;
+}
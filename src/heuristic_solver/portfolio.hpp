@@ -0,0 +1,46 @@
+#ifndef PACE2024_PORTFOLIO_HPP
+#define PACE2024_PORTFOLIO_HPP
+
+#include "../pace_graph/cancellation.hpp"
+#include "../pace_graph/config.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+
+#include <vector>
+
+class PortfolioParameter {
+  public:
+    bool useBarycenter = true;
+    bool useMedian = true;
+    /**
+     * Only used if the crossing matrix is initialized, as greedy insertion
+     * takes O(n^2) time.
+     */
+    bool useGreedyInsertion = true;
+    /** Only used for cutwidth graphs (see PaceGraph::cutwidth_order). */
+    bool useCutwidthOrder = true;
+    /** Improves the barycenter and median orders by swapping neighbors. */
+    bool useSwapping = true;
+
+    /** Number of best, pairwise different orders that are returned. */
+    int numberOfOrders = 1;
+
+    /** Overrides the fields that are given in config as "portfolio.<field>". */
+    void load(const Config &config);
+};
+
+/**
+ * Runs the cheap construction heuristics (cutwidth order, median,
+ * barycenter, greedy insertion) concurrently, at most one per thread. When
+ * cancellation is cancelled, greedy insertion and the swapping stop, the
+ * median and barycenter orders are still computed. With a single thread the
+ * cheap heuristics run first.
+ *
+ * @return the numberOfOrders cheapest different orders, the cheapest first.
+ * Contains at least one order
+ */
+std::vector<Order> initial_orders(PaceGraph &graph,
+                                  const PortfolioParameter &parameter,
+                                  const CancellationToken &cancellation);
+
+#endif // PACE2024_PORTFOLIO_HPP
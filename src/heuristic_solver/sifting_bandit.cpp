@@ -0,0 +1,47 @@
+#include "sifting_bandit.hpp"
+#include "local_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SiftingBandit::SiftingBandit(double exploration) : exploration(exploration) {
+    for (auto siftingType : {SiftingType::Random, SiftingType::DegreeOrder,
+                             SiftingType::DegreeOrderReverse}) {
+        for (auto insertionType :
+             {SiftingInsertionType::First, SiftingInsertionType::Last,
+              SiftingInsertionType::Random}) {
+            Arm arm;
+            arm.siftingType = siftingType;
+            arm.siftingInsertionType = insertionType;
+            arms.push_back(arm);
+        }
+    }
+}
+
+int SiftingBandit::select() {
+    int best = 0;
+    double bestScore = -1;
+    for (int i = 0; i < size(); ++i) {
+        if (arms[i].pulls == 0) {
+            return i;
+        }
+        double mean = arms[i].rateSum / arms[i].pulls;
+        double normalizedMean = bestRate > 0 ? mean / bestRate : 0;
+        double score =
+            normalizedMean + exploration * std::sqrt(std::log(totalPulls) /
+                                                     arms[i].pulls);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void SiftingBandit::update(int arm, long improvement, double microseconds) {
+    double rate = std::max(0L, improvement) / std::max(1.0, microseconds);
+    arms[arm].pulls++;
+    arms[arm].rateSum += rate;
+    totalPulls++;
+    bestRate = std::max(bestRate, rate);
+}
@@ -0,0 +1,52 @@
+#ifndef PACE2024_SIFTING_BANDIT_HPP
+#define PACE2024_SIFTING_BANDIT_HPP
+
+#include <vector>
+
+enum class SiftingType;
+enum class SiftingInsertionType;
+
+/**
+ * Chooses the SiftingType and SiftingInsertionType of local searches online
+ * with UCB1. The reward of a local search is its improvement per
+ * microsecond, divided by the best rate seen so far. Not thread safe, every
+ * thread needs its own bandit.
+ */
+class SiftingBandit {
+  public:
+    class Arm {
+      public:
+        SiftingType siftingType;
+        SiftingInsertionType siftingInsertionType;
+        long pulls = 0;
+        /** Sum of the improvements per microsecond. */
+        double rateSum = 0;
+    };
+
+  private:
+    std::vector<Arm> arms;
+    long totalPulls = 0;
+    double bestRate = 0;
+    double exploration;
+
+  public:
+    /**
+     * @param exploration weight of the UCB1 exploration term, sqrt(2) in the
+     * original analysis
+     */
+    explicit SiftingBandit(double exploration = 0.5);
+
+    /** @return the arm to use for the next local search */
+    int select();
+
+    /**
+     * Reports the result of a local search that used arm.
+     * @param improvement decrease of the cost (positive)
+     */
+    void update(int arm, long improvement, double microseconds);
+
+    const Arm &operator[](int arm) const { return arms[arm]; }
+    int size() const { return arms.size(); }
+};
+
+#endif // PACE2024_SIFTING_BANDIT_HPP
@@ -0,0 +1,202 @@
+#include "simulated_annealing.hpp"
+#include "../lb/simple_lb.hpp"
+#include "../pace_graph/parallel.hpp"
+#include "../pace_graph/random.hpp"
+#include "local_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+/** Random insertion position at most maxDistance away from position. */
+int random_target(int position, int size, int maxDistance, Xoshiro256 &rng) {
+    int from = std::max(0, position - maxDistance);
+    int to = std::min(size - 1, position + maxDistance);
+    // Skips position itself.
+    int target = from + rng.next_below(to - from);
+    return target >= position ? target + 1 : target;
+}
+
+/**
+ * Makes size random insertion moves on order at the given temperature and
+ * accepts them with the Metropolis criterion.
+ */
+void sweep(Order &order, int size, int maxDistance, double temperature,
+           Xoshiro256 &rng, const CancellationToken &cancellation) {
+    for (int i = 0; i < size && !cancellation.is_cancelled(); ++i) {
+        int v = rng.next_below(size);
+        int target =
+            random_target(order.get_position(v), size, maxDistance, rng);
+        long costChange = order.move_cost_change(v, target);
+        if (costChange <= 0 ||
+            rng.next_double() < std::exp(-costChange / temperature)) {
+            order.move_vertex(v, target, costChange);
+        }
+    }
+}
+
+} // namespace
+
+void SimulatedAnnealingParameter::load(const Config &config) {
+    config.load("annealing.maxMoveDistance", maxMoveDistance);
+    config.load("annealing.startAcceptance", startAcceptance);
+    config.load("annealing.endTemperatureRatio", endTemperatureRatio);
+    config.load("annealing.sweepsPerCycle", sweepsPerCycle);
+    config.load("annealing.numberOfReplicas", numberOfReplicas);
+    config.load("annealing.annealingTimeShare", annealingTimeShare);
+    portfolioParameter.load(config);
+}
+
+double SimulatedAnnealing::estimate_temperature(PaceGraph &graph, Order &order,
+                                                double acceptance) {
+    const int size = graph.size_free;
+    const int samples = std::min(1000, 10 * size);
+    auto &rng = thread_rng();
+
+    long uphillSum = 0;
+    int uphillMoves = 0;
+    for (int i = 0; i < samples; ++i) {
+        int v = rng.next_below(size);
+        int target = random_target(order.get_position(v), size,
+                                   parameter.maxMoveDistance, rng);
+        long costChange = order.move_cost_change(v, target);
+        if (costChange > 0) {
+            uphillSum += costChange;
+            uphillMoves++;
+        }
+    }
+
+    double averageUphill =
+        uphillMoves > 0 ? static_cast<double>(uphillSum) / uphillMoves : 1.0;
+    return averageUphill / -std::log(acceptance);
+}
+
+Order SimulatedAnnealing::anneal(PaceGraph &graph, Order order, long lb) {
+    const int size = graph.size_free;
+    auto &rng = thread_rng();
+
+    double startTemperature =
+        estimate_temperature(graph, order, parameter.startAcceptance);
+    double cooling = std::pow(parameter.endTemperatureRatio,
+                              1.0 / std::max(1, parameter.sweepsPerCycle));
+
+    Order bestOrder = order;
+    int sweeps = 0;
+    int cycles = 0;
+    double temperature = startTemperature;
+    while (has_time_left(sweeps) && !annealingCancellation.is_cancelled() &&
+           bestOrder.get_crossings() > lb) {
+        sweep(order, size, parameter.maxMoveDistance, temperature, rng,
+              annealingCancellation);
+        sweeps++;
+
+        if (order.get_crossings() < bestOrder.get_crossings()) {
+            bestOrder = order;
+        }
+
+        temperature *= cooling;
+        if (temperature < startTemperature * parameter.endTemperatureRatio) {
+            // Reheat, starting again from the best order.
+            temperature = startTemperature;
+            order = bestOrder;
+            cycles++;
+        }
+    }
+
+    std::cerr << "# Sweeps: " << sweeps << std::endl;
+    std::cerr << "# Cycles: " << cycles << std::endl;
+    return bestOrder;
+}
+
+Order SimulatedAnnealing::parallel_tempering(PaceGraph &graph, Order order,
+                                             long lb) {
+    const int size = graph.size_free;
+    const int replicas = parameter.numberOfReplicas;
+    auto &rng = thread_rng();
+
+    // Geometric temperature ladder, replica 0 is the hottest.
+    double startTemperature =
+        estimate_temperature(graph, order, parameter.startAcceptance);
+    std::vector<double> temperatures(replicas);
+    for (int i = 0; i < replicas; ++i) {
+        temperatures[i] =
+            startTemperature *
+            std::pow(parameter.endTemperatureRatio,
+                     static_cast<double>(i) / std::max(1, replicas - 1));
+    }
+
+    // The orders move between the temperatures, their generators stay with
+    // the replica slot so that a run only depends on the seed.
+    std::vector<Order> orders(replicas, order);
+    std::vector<Xoshiro256> generators;
+    generators.reserve(replicas);
+    for (int i = 0; i < replicas; ++i) {
+        generators.emplace_back(rng());
+    }
+
+    Order bestOrder = order;
+    int sweeps = 0;
+    long swaps = 0;
+    while (has_time_left(sweeps) && !annealingCancellation.is_cancelled() &&
+           bestOrder.get_crossings() > lb) {
+        // The replicas only read the crossing matrix.
+        parallel_for(0, replicas, 1, [&](int from, int to, int) {
+            for (int i = from; i < to; ++i) {
+                sweep(orders[i], size, parameter.maxMoveDistance,
+                      temperatures[i], generators[i],
+                      annealingCancellation);
+            }
+        });
+        sweeps++;
+
+        for (int i = 0; i < replicas; ++i) {
+            if (orders[i].get_crossings() < bestOrder.get_crossings()) {
+                bestOrder = orders[i];
+            }
+        }
+
+        // Replica exchange between neighboring temperatures.
+        for (int i = sweeps % 2; i + 1 < replicas; i += 2) {
+            double exponent =
+                (1.0 / temperatures[i] - 1.0 / temperatures[i + 1]) *
+                static_cast<double>(orders[i].get_crossings() -
+                                    orders[i + 1].get_crossings());
+            if (exponent >= 0 || rng.next_double() < std::exp(exponent)) {
+                std::swap(orders[i], orders[i + 1]);
+                swaps++;
+            }
+        }
+    }
+
+    std::cerr << "# Sweeps: " << sweeps << std::endl;
+    std::cerr << "# Replica swaps: " << swaps << std::endl;
+    return bestOrder;
+}
+
+Order SimulatedAnnealing::solve(PaceGraph &graph) {
+    graph.init_crossing_matrix_if_necessary();
+
+    SimpleLBParameter lbParameter;
+    lbParameter.maxNrOfConflicts = 100000;
+    long lb = simpleLB(graph, lbParameter, cancellation);
+
+    Order order =
+        initial_orders(graph, parameter.portfolioParameter, cancellation)
+            .front();
+    order.track_crossings(graph);
+
+    LocalSearchParameter localSearchParameter;
+    local_search(graph, order, localSearchParameter, cancellation);
+    if (graph.size_free < 2 || order.get_crossings() <= lb) {
+        return order;
+    }
+
+    Order bestOrder = parameter.numberOfReplicas > 1
+                          ? parallel_tempering(graph, order, lb)
+                          : anneal(graph, order, lb);
+
+    local_search(graph, bestOrder, localSearchParameter, cancellation);
+    return bestOrder;
+}
@@ -0,0 +1,94 @@
+#ifndef PACE2024_SIMULATED_ANNEALING_HPP
+#define PACE2024_SIMULATED_ANNEALING_HPP
+
+#include "../pace_graph/config.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+#include "heuristic.hpp"
+#include "portfolio.hpp"
+
+class SimulatedAnnealingParameter {
+  public:
+    /** Moves go at most this many positions to the left or right. */
+    int maxMoveDistance = 50;
+    /**
+     * The start temperature accepts an average uphill move with this
+     * probability. The average is estimated from random moves.
+     */
+    double startAcceptance = 0.3;
+    /** The schedule ends at endTemperatureRatio * start temperature. */
+    double endTemperatureRatio = 0.01;
+    /**
+     * Number of sweeps (n moves each) from the start to the end temperature.
+     * The temperature decreases geometrically after every sweep. At the end
+     * the schedule starts over from the best order found.
+     */
+    int sweepsPerCycle = 200;
+
+    /**
+     * Number of replicas for parallel tempering. Each replica anneals at a
+     * fixed temperature between the start and end temperature, on its own
+     * thread. Neighboring replicas swap their orders after every sweep with
+     * the Metropolis probability. With 1 replica the geometric schedule is
+     * used.
+     */
+    int numberOfReplicas = 1;
+
+    /**
+     * HeuristicSolver stops the annealing at this fraction of its time
+     * limit, the rest is left for the local search of the best order.
+     */
+    double annealingTimeShare = 0.9;
+
+    /** Constructs the start order. */
+    PortfolioParameter portfolioParameter;
+
+    /**
+     * Overrides the fields that are given in config as "annealing.<field>"
+     * (and "portfolio.<field>" for portfolioParameter).
+     */
+    void load(const Config &config);
+};
+
+/**
+ * Simulated annealing with random insertion moves of bounded distance. The
+ * cost change of a move is computed from the crossing matrix in O(distance).
+ * The best order found is improved with local search at the end, which only
+ * runs if the annealing stopped before cancellation (see annealingCancellation).
+ */
+class SimulatedAnnealing : public Heuristic {
+  private:
+    /** Temperature that accepts an average uphill move with acceptance. */
+    double estimate_temperature(PaceGraph &graph, Order &order,
+                                double acceptance);
+    Order anneal(PaceGraph &graph, Order order, long lb);
+    Order parallel_tempering(PaceGraph &graph, Order order, long lb);
+
+    /**
+     * Stops the annealing (but not the local search afterwards). Must be
+     * cancelled no later than cancellation.
+     */
+    CancellationToken annealingCancellation;
+
+  public:
+    SimulatedAnnealingParameter parameter;
+
+    explicit SimulatedAnnealing(
+        std::function<bool(int)> has_time_left,
+        SimulatedAnnealingParameter parameter,
+        CancellationToken cancellation = CancellationToken())
+        : SimulatedAnnealing(std::move(has_time_left), parameter, cancellation,
+                             cancellation) {}
+
+    SimulatedAnnealing(std::function<bool(int)> has_time_left,
+                       SimulatedAnnealingParameter parameter,
+                       CancellationToken cancellation,
+                       CancellationToken annealingCancellation)
+        : Heuristic(std::move(has_time_left), std::move(cancellation)),
+          annealingCancellation(std::move(annealingCancellation)),
+          parameter(parameter) {}
+
+    Order solve(PaceGraph &graph) override;
+};
+
+#endif // PACE2024_SIMULATED_ANNEALING_HPP
@@ -0,0 +1,78 @@
+#include "tabu_search.hpp"
+#include "../pace_graph/random.hpp"
+#include "local_search.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+void TabuSearchParameter::load(const Config &config) {
+    config.load("tabu.tenure", tenure);
+    config.load("tabu.candidates", candidates);
+    config.load("tabu.maxMovesWithoutImprovement", maxMovesWithoutImprovement);
+}
+
+long tabu_search(PaceGraph &graph, Order &order,
+                 const TabuSearchParameter &parameter,
+                 const CancellationToken &cancellation) {
+    const int size = graph.size_free;
+    if (size < 2) {
+        return 0;
+    }
+
+    auto &rng = thread_rng();
+    int tenure = parameter.tenure > 0
+                     ? parameter.tenure
+                     : static_cast<int>(std::sqrt(static_cast<double>(size)));
+
+    Order bestOrder = order;
+    const long startCost = order.get_crossings();
+    long bestCost = startCost;
+
+    // A vertex is tabu while tabuUntil[v] > move.
+    std::vector<long> tabuUntil(size, 0);
+    int movesWithoutImprovement = 0;
+    for (long move = 1; movesWithoutImprovement <
+                            parameter.maxMovesWithoutImprovement &&
+                        !cancellation.is_cancelled();
+         ++move) {
+        int bestVertex = -1;
+        int bestPosition = 0;
+        long bestCostChange = std::numeric_limits<long>::max();
+
+        for (int i = 0; i < parameter.candidates; ++i) {
+            int v = rng.next_below(size);
+            int position;
+            long costChange = best_insertion_move(graph, order, v, position);
+            if (position == order.get_position(v) ||
+                costChange >= bestCostChange) {
+                continue;
+            }
+
+            bool aspiration = order.get_crossings() + costChange < bestCost;
+            if (tabuUntil[v] > move && !aspiration) {
+                continue;
+            }
+            bestVertex = v;
+            bestPosition = position;
+            bestCostChange = costChange;
+        }
+
+        movesWithoutImprovement++;
+        if (bestVertex == -1) {
+            continue;
+        }
+
+        order.move_vertex(bestVertex, bestPosition, bestCostChange);
+        tabuUntil[bestVertex] = move + tenure + rng.next_below(tenure + 1);
+
+        if (order.get_crossings() < bestCost) {
+            bestCost = order.get_crossings();
+            bestOrder = order;
+            movesWithoutImprovement = 0;
+        }
+    }
+
+    order = bestOrder;
+    return bestCost - startCost;
+}
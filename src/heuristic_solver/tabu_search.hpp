@@ -0,0 +1,40 @@
+#ifndef PACE2024_TABU_SEARCH_HPP
+#define PACE2024_TABU_SEARCH_HPP
+
+#include "../pace_graph/cancellation.hpp"
+#include "../pace_graph/config.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+
+class TabuSearchParameter {
+  public:
+    /**
+     * Number of moves after moving a vertex, in which the vertex may only
+     * move again if this leads to a new best order (aspiration). A random
+     * part of up to the same size is added to every tenure. 0 chooses
+     * sqrt(n).
+     */
+    int tenure = 0;
+    /** Number of random vertices whose best move is evaluated per move. */
+    int candidates = 32;
+    /** Stops after this many moves without finding a new best order. */
+    int maxMovesWithoutImprovement = 5000;
+
+    /** Overrides the fields that are given in config as "tabu.<field>". */
+    void load(const Config &config);
+};
+
+/**
+ * Tabu search over insertion moves: every step moves the vertex with the best
+ * move (see best_insertion_move) among random candidates to its best
+ * position, even if this makes the order worse. Recently moved vertices are
+ * tabu. Needs the crossing matrix and an order that tracks its crossings.
+ *
+ * @param order the start order. It is replaced by the best order found
+ * @return the improvement in the cost of the order
+ */
+long tabu_search(PaceGraph &graph, Order &order,
+                 const TabuSearchParameter &parameter,
+                 const CancellationToken &cancellation);
+
+#endif // PACE2024_TABU_SEARCH_HPP
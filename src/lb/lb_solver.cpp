@@ -4,7 +4,8 @@
 #include <iostream>
 long LBSolver::run(PaceGraph &graph) {
     SimpleLBParameter parameter;
-    return simpleLB(graph, parameter);
+    parameter.load(solver_config());
+    return simpleLB(graph, parameter, cancellation());
 }
 void LBSolver::finish(PaceGraph &graph,
                       std::vector<std::unique_ptr<PaceGraph>> &subgraphs,
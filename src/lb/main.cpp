@@ -1,7 +1,12 @@
+#include "../pace_graph/arguments.hpp"
 #include "lb_solver.hpp"
 #include <iostream>
 
-int main() {
+int main(int argc, char *argv[]) {
+    apply_seed_argument(argc, argv);
+    apply_threads_argument(argc, argv);
+    apply_config_argument(argc, argv);
+
     PaceGraph graph = PaceGraph::from_gr(std::cin);
     LBSolver lbSolver;
     lbSolver.solve(graph);
@@ -3,12 +3,25 @@
 //
 
 #include "simple_lb.hpp"
+#include "../pace_graph/random.hpp"
 #include <algorithm>
 #include <bitset>
 #include <random>
 
+void SimpleLBParameter::load(const Config &config) {
+    config.load("simple_lb.usePotentialMatrix", usePotentialMatrix);
+    config.load("simple_lb.testForceChoiceOfConflicts",
+                testForceChoiceOfConflicts);
+    config.load("simple_lb.nrOfConflictsToUsePseudoRandom",
+                nrOfConflictsToUsePseudoRandom);
+    config.load("simple_lb.maxNrOfConflicts", maxNrOfConflicts);
+    config.load("simple_lb.numberOfIterationsForConflictOrder",
+                numberOfIterationsForConflictOrder);
+}
+
 std::vector<std::tuple<int, int, int>>
-getConflictPairsBitmap(PaceGraph &graph, SimpleLBParameter &parameter) {
+getConflictPairsBitmap(PaceGraph &graph, SimpleLBParameter &parameter,
+                       const CancellationToken &cancellation) {
     std::vector<std::tuple<int, int, int>> conflictPairs;
 
     std::vector<std::bitset<MAX_MATRIX_SIZE>> edges(graph.size_free);
@@ -39,7 +52,8 @@ getConflictPairsBitmap(PaceGraph &graph, SimpleLBParameter &parameter) {
             }
         }
 
-        if (conflictPairs.size() > parameter.maxNrOfConflicts) {
+        if (conflictPairs.size() > parameter.maxNrOfConflicts ||
+            cancellation.is_cancelled()) {
             break;
         }
     }
@@ -48,7 +62,7 @@ getConflictPairsBitmap(PaceGraph &graph, SimpleLBParameter &parameter) {
 }
 
 void fisherYatesShuffle(std::vector<std::tuple<int, int, int>> &conflictPairs,
-                        std::mt19937 &rng) {
+                        Xoshiro256 &rng) {
     for (int i = conflictPairs.size() - 1; i > (conflictPairs.size() / 2);
          --i) {
         std::uniform_int_distribution<int> dist(0, i);
@@ -58,8 +72,9 @@ void fisherYatesShuffle(std::vector<std::tuple<int, int, int>> &conflictPairs,
 }
 
 long improveWithPotential(PaceGraph &graph, SimpleLBParameter &parameter,
-                          long currentLB) {
-    auto conflictPairs = getConflictPairsBitmap(graph, parameter);
+                          long currentLB,
+                          const CancellationToken &cancellation) {
+    auto conflictPairs = getConflictPairsBitmap(graph, parameter, cancellation);
 
     if (conflictPairs.empty() ||
         conflictPairs.size() >= parameter.maxNrOfConflicts) {
@@ -68,9 +83,10 @@ long improveWithPotential(PaceGraph &graph, SimpleLBParameter &parameter,
 
     long bestLBImprovement = 0;
 
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    for (int _ = 0; _ < parameter.numberOfIterationsForConflictOrder; _++) {
+    auto &rng = thread_rng();
+    for (int _ = 0; _ < parameter.numberOfIterationsForConflictOrder &&
+                    !cancellation.is_cancelled();
+         _++) {
         if (parameter.nrOfConflictsToUsePseudoRandom < conflictPairs.size()) {
             if (_ % 2 == 0) {
                 fisherYatesShuffle(conflictPairs, rng);
@@ -140,12 +156,14 @@ long improveWithPotential(PaceGraph &graph, SimpleLBParameter &parameter,
     return bestLBImprovement;
 }
 
-long simpleLB(PaceGraph &graph, SimpleLBParameter &parameter) {
+long simpleLB(PaceGraph &graph, SimpleLBParameter &parameter,
+              const CancellationToken &cancellation) {
     bool canInitCrossingMatrix = graph.init_crossing_matrix_if_necessary();
     long lb = 0;
 
     if (!canInitCrossingMatrix) {
-        for (int u = 0; u < graph.size_free; ++u) {
+        for (int u = 0; u < graph.size_free && !cancellation.is_cancelled();
+             ++u) {
             for (int v = u + 1; v < graph.size_free; v++) {
                 int crossing_matrix_u_v;
                 int crossing_matrix_v_u;
@@ -166,7 +184,7 @@ long simpleLB(PaceGraph &graph, SimpleLBParameter &parameter) {
     }
 
     if (parameter.usePotentialMatrix) {
-        lb += improveWithPotential(graph, parameter, lb);
+        lb += improveWithPotential(graph, parameter, lb, cancellation);
     }
 
     if (graph.lb < lb) {
@@ -5,6 +5,8 @@
 #ifndef PACE2024_SIMPLE_LB_HPP
 #define PACE2024_SIMPLE_LB_HPP
 
+#include "../pace_graph/cancellation.hpp"
+#include "../pace_graph/config.hpp"
 #include "../pace_graph/pace_graph.hpp"
 
 class SimpleLBParameter {
@@ -16,8 +18,18 @@ class SimpleLBParameter {
     int maxNrOfConflicts = 10000000;
 
     int numberOfIterationsForConflictOrder = 100;
+
+    /**
+     * Overrides the fields that are given in config as "simple_lb.<field>".
+     */
+    void load(const Config &config);
 };
 
-long simpleLB(PaceGraph &graph, SimpleLBParameter &parameter);
+/**
+ * Computes a lower bound for the number of crossings. When cancelled, the
+ * bound found so far is returned, which is still a valid lower bound.
+ */
+long simpleLB(PaceGraph &graph, SimpleLBParameter &parameter,
+              const CancellationToken &cancellation = CancellationToken());
 
 #endif // PACE2024_SIMPLE_LB_HPP
@@ -0,0 +1,63 @@
+#ifndef PACE2024_ARGUMENTS_HPP
+#define PACE2024_ARGUMENTS_HPP
+
+#include "config.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/**
+ * Returns the value of a command line option given as "--name value" or
+ * "--name=value", or nullptr if the option is missing.
+ */
+inline const char *get_argument(int argc, char *argv[], const char *name) {
+    const size_t length = std::strlen(name);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], name, length) != 0) {
+            continue;
+        }
+        if (argv[i][length] == '=') {
+            return argv[i] + length + 1;
+        }
+        if (argv[i][length] == '\0' && i + 1 < argc) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Applies the "--seed" option to the random generators. Without the option a
+ * random seed is used. The seed is printed to make every run reproducible.
+ */
+inline void apply_seed_argument(int argc, char *argv[]) {
+    if (const char *seed = get_argument(argc, argv, "--seed")) {
+        set_random_seed(std::stoull(seed));
+    }
+    std::cerr << "# Seed: " << get_random_seed() << std::endl;
+}
+
+/**
+ * Applies the "--threads" option (see set_number_of_threads). Without the
+ * option all hardware threads are used.
+ */
+inline void apply_threads_argument(int argc, char *argv[]) {
+    if (const char *threads = get_argument(argc, argv, "--threads")) {
+        set_number_of_threads(std::stoi(threads));
+    }
+}
+
+/**
+ * Loads the parameter file given by the "--config" option into solver_config().
+ * The solvers apply it to their parameters before the other options.
+ */
+inline void apply_config_argument(int argc, char *argv[]) {
+    if (const char *path = get_argument(argc, argv, "--config")) {
+        solver_config() = Config::from_file(path);
+        std::cerr << "# Config: " << path << std::endl;
+    }
+}
+
+#endif // PACE2024_ARGUMENTS_HPP
@@ -0,0 +1,117 @@
+#include "cancellation.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** How often the timer checks for parents that were cancelled. */
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(5);
+
+std::atomic<bool> all_tokens_cancelled{false};
+
+} // namespace
+
+namespace cancellation_detail {
+
+/**
+ * Background thread that cancels the tokens created with deadlines. It only
+ * wakes up while there are such tokens.
+ */
+class DeadlineTimer {
+  private:
+    struct Entry {
+        std::chrono::steady_clock::time_point deadline;
+        CancellationToken token;
+        CancellationToken parent;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake_up;
+    std::vector<Entry> entries;
+    bool stopping = false;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            auto now = std::chrono::steady_clock::now();
+            bool cancelAll =
+                all_tokens_cancelled.load(std::memory_order_relaxed);
+
+            auto expired = [&](const Entry &entry) {
+                if (cancelAll || now >= entry.deadline ||
+                    entry.parent.is_cancelled()) {
+                    entry.token.cancel();
+                    return true;
+                }
+                // Nobody else can observe this token anymore.
+                return entry.token.cancelled.use_count() == 1;
+            };
+            entries.erase(
+                std::remove_if(entries.begin(), entries.end(), expired),
+                entries.end());
+
+            if (entries.empty()) {
+                wake_up.wait(lock);
+                continue;
+            }
+
+            auto next = now + POLL_INTERVAL;
+            for (const auto &entry : entries) {
+                next = std::min(next, entry.deadline);
+            }
+            wake_up.wait_until(lock, next);
+        }
+    }
+
+  public:
+    DeadlineTimer() : worker([this]() { run(); }) {}
+
+    ~DeadlineTimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake_up.notify_one();
+        worker.join();
+    }
+
+    void add(std::chrono::steady_clock::time_point deadline,
+             const CancellationToken &token,
+             const CancellationToken &parent) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.push_back({deadline, token, parent});
+        }
+        wake_up.notify_one();
+    }
+
+    static DeadlineTimer &instance() {
+        static DeadlineTimer timer;
+        return timer;
+    }
+};
+
+} // namespace cancellation_detail
+
+CancellationToken
+CancellationToken::with_deadline(std::chrono::steady_clock::time_point deadline,
+                                 const CancellationToken &parent) {
+    CancellationToken token;
+    if (parent.is_cancelled() ||
+        all_tokens_cancelled.load(std::memory_order_relaxed)) {
+        token.cancel();
+    } else {
+        cancellation_detail::DeadlineTimer::instance().add(deadline, token,
+                                                           parent);
+    }
+    return token;
+}
+
+void cancel_all_tokens() {
+    all_tokens_cancelled.store(true, std::memory_order_relaxed);
+}
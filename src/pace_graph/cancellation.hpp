@@ -0,0 +1,66 @@
+#ifndef PACE2024_CANCELLATION_HPP
+#define PACE2024_CANCELLATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace cancellation_detail {
+class DeadlineTimer;
+} // namespace cancellation_detail
+
+/**
+ * Tells long running algorithms to stop. Copies share the same state, so a
+ * token can be handed down by value. Checking it is a single relaxed atomic
+ * load, cheap enough for the innermost loops (unlike reading the clock).
+ */
+class CancellationToken {
+  private:
+    std::shared_ptr<std::atomic<bool>> cancelled;
+
+    friend class cancellation_detail::DeadlineTimer;
+
+  public:
+    /** Creates a token that is only cancelled by calling cancel(). */
+    CancellationToken()
+        : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /**
+     * @return a token that is cancelled at the deadline (by a timer thread),
+     * when parent is cancelled or when the process receives SIGTERM (see
+     * cancel_all_tokens).
+     */
+    static CancellationToken
+    with_deadline(std::chrono::steady_clock::time_point deadline,
+                  const CancellationToken &parent = CancellationToken());
+
+    /** @return a token that is cancelled after the given duration. */
+    static CancellationToken
+    with_timeout(std::chrono::steady_clock::duration duration,
+                 const CancellationToken &parent = CancellationToken()) {
+        return with_deadline(std::chrono::steady_clock::now() + duration,
+                             parent);
+    }
+
+    void cancel() const { cancelled->store(true, std::memory_order_relaxed); }
+
+    bool is_cancelled() const {
+        return cancelled->load(std::memory_order_relaxed);
+    }
+
+    bool has_time_left() const { return !is_cancelled(); }
+
+    /**
+     * @return the flag of this token. Setting it is async-signal-safe, use it
+     * to cancel a token from a signal handler.
+     */
+    std::atomic<bool> *flag() const { return cancelled.get(); }
+};
+
+/**
+ * Cancels every token created with CancellationToken::with_deadline within a
+ * few milliseconds. Async-signal-safe.
+ */
+void cancel_all_tokens();
+
+#endif // PACE2024_CANCELLATION_HPP
@@ -0,0 +1,77 @@
+#include "config.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string &s) {
+    const char *whitespace = " \t\r";
+    size_t begin = s.find_first_not_of(whitespace);
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(whitespace);
+    return s.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+Config Config::from_stream(std::istream &in) {
+    Config config;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("ERROR: Config line without '=': " +
+                                        line);
+        }
+        config.set(trim(line.substr(0, separator)),
+                   trim(line.substr(separator + 1)));
+    }
+    return config;
+}
+
+Config Config::from_file(const std::string &file_path) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Failed to open config file.");
+    }
+    return from_stream(file);
+}
+
+void Config::load(const std::string &key, int &value) const {
+    auto it = values.find(key);
+    if (it != values.end()) {
+        value = std::stoi(it->second);
+    }
+}
+
+void Config::load(const std::string &key, double &value) const {
+    auto it = values.find(key);
+    if (it != values.end()) {
+        value = std::stod(it->second);
+    }
+}
+
+void Config::load(const std::string &key, bool &value) const {
+    auto it = values.find(key);
+    if (it != values.end()) {
+        value = it->second == "1" || it->second == "true";
+    }
+}
+
+void Config::write(std::ostream &out) const {
+    for (const auto &[key, value] : values) {
+        out << key << " = " << value << "\n";
+    }
+}
+
+Config &solver_config() {
+    static Config config;
+    return config;
+}
@@ -0,0 +1,52 @@
+#ifndef PACE2024_CONFIG_HPP
+#define PACE2024_CONFIG_HPP
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * Parameter values read from "key = value" lines. Empty lines and lines
+ * starting with '#' are ignored. The keys are "<prefix>.<field name>" of the
+ * parameter classes, e.g. "genetic.numberOfForceSwapPositions", enums are
+ * given by their integer value.
+ */
+class Config {
+  private:
+    std::map<std::string, std::string> values;
+
+  public:
+    static Config from_stream(std::istream &in);
+    static Config from_file(const std::string &file_path);
+
+    void set(const std::string &key, const std::string &value) {
+        values[key] = value;
+    }
+    bool contains(const std::string &key) const {
+        return values.count(key) > 0;
+    }
+    bool empty() const { return values.empty(); }
+
+    /** Sets value to the value of key, if the config contains the key. */
+    void load(const std::string &key, int &value) const;
+    void load(const std::string &key, double &value) const;
+    void load(const std::string &key, bool &value) const;
+
+    template <typename Enum>
+    void load_enum(const std::string &key, Enum &value) const {
+        int integer = static_cast<int>(value);
+        load(key, integer);
+        value = static_cast<Enum>(integer);
+    }
+
+    void write(std::ostream &out) const;
+};
+
+/**
+ * The config of the solvers, empty unless it was set by the "--config" option
+ * (see apply_config_argument).
+ */
+Config &solver_config();
+
+#endif // PACE2024_CONFIG_HPP
@@ -0,0 +1,407 @@
+#include "crossing_kernels.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <immintrin.h>
+
+namespace {
+
+long sum_row_after_position_scalar(const int *row,
+                                   const int *vertex_to_position, int size,
+                                   int position) {
+    long sum = 0;
+    for (int v = 0; v < size; ++v) {
+        sum += vertex_to_position[v] > position ? row[v] : 0;
+    }
+    return sum;
+}
+
+__attribute__((target("avx2"))) long
+sum_row_after_position_avx2(const int *row, const int *vertex_to_position,
+                            int size, int position) {
+    const __m256i pos = _mm256_set1_epi32(position);
+    __m256i sumLow = _mm256_setzero_si256();
+    __m256i sumHigh = _mm256_setzero_si256();
+
+    int v = 0;
+    for (; v + 8 <= size; v += 8) {
+        __m256i positions = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(vertex_to_position + v));
+        __m256i values =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + v));
+        values = _mm256_and_si256(values, _mm256_cmpgt_epi32(positions, pos));
+
+        // Accumulate in 64 bit, the entries of constrained pairs are large.
+        sumLow = _mm256_add_epi64(
+            sumLow, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        sumHigh = _mm256_add_epi64(
+            sumHigh, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+
+    alignas(32) long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes),
+                       _mm256_add_epi64(sumLow, sumHigh));
+    long sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    return sum + sum_row_after_position_scalar(
+                     row + v, vertex_to_position + v, size - v, position);
+}
+
+__attribute__((target("avx512f"))) long
+sum_row_after_position_avx512(const int *row, const int *vertex_to_position,
+                              int size, int position) {
+    const __m512i pos = _mm512_set1_epi32(position);
+    __m512i sumLow = _mm512_setzero_si512();
+    __m512i sumHigh = _mm512_setzero_si512();
+
+    int v = 0;
+    for (; v < size; v += 16) {
+        __mmask16 inRange =
+            size - v >= 16 ? 0xFFFF : (__mmask16)((1u << (size - v)) - 1);
+        __m512i positions =
+            _mm512_maskz_loadu_epi32(inRange, vertex_to_position + v);
+        __mmask16 after =
+            _mm512_mask_cmpgt_epi32_mask(inRange, positions, pos);
+        __m512i values = _mm512_maskz_loadu_epi32(after, row + v);
+
+        sumLow = _mm512_add_epi64(
+            sumLow, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(values)));
+        sumHigh = _mm512_add_epi64(
+            sumHigh,
+            _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(values, 1)));
+    }
+
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(sumLow, sumHigh));
+}
+
+void gather_row_scalar(const int *row, const int *vertices, int step,
+                       int count, int sign, int *out) {
+    for (int k = 0; k < count; ++k) {
+        out[k] = sign * row[vertices[k * step]];
+    }
+}
+
+__attribute__((target("avx2"))) void
+gather_row_avx2(const int *row, const int *vertices, int step, int count,
+                int sign, int *out) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i signs = _mm256_set1_epi32(sign);
+
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m256i indices;
+        if (step == 1) {
+            indices = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(vertices + k));
+        } else {
+            indices = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(vertices - k - 7)),
+                reverse);
+        }
+        __m256i values = _mm256_i32gather_epi32(row, indices, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + k),
+                            _mm256_sign_epi32(values, signs));
+    }
+
+    gather_row_scalar(row, vertices + k * step, step, count - k, sign,
+                      out + k);
+}
+
+__attribute__((target("avx512f"))) void
+gather_row_avx512(const int *row, const int *vertices, int step, int count,
+                  int sign, int *out) {
+    const __m512i reverse = _mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7,
+                                              6, 5, 4, 3, 2, 1, 0);
+    const __m512i signs = _mm512_set1_epi32(sign);
+
+    int k = 0;
+    for (; k + 16 <= count; k += 16) {
+        __m512i indices;
+        if (step == 1) {
+            indices = _mm512_loadu_si512(vertices + k);
+        } else {
+            indices = _mm512_permutexvar_epi32(
+                reverse, _mm512_loadu_si512(vertices - k - 15));
+        }
+        __m512i values = _mm512_i32gather_epi32(indices, row, 4);
+        _mm512_storeu_si512(out + k, _mm512_mullo_epi32(values, signs));
+    }
+
+    gather_row_scalar(row, vertices + k * step, step, count - k, sign,
+                      out + k);
+}
+
+PrefixMinimum prefix_minimum_scalar(const int *values, int count, long start,
+                                    int barrier) {
+    PrefixMinimum result{start, LONG_MAX, -1, -1, 0, count, 0};
+    long prefix = start;
+    for (int k = 0; k < count; ++k) {
+        if (values[k] >= barrier) {
+            result.scanned = k;
+            break;
+        }
+        prefix += values[k];
+        result.negativeTotal += std::min(values[k], 0);
+        if (prefix < result.minimum) {
+            result.minimum = prefix;
+            result.first = k;
+            result.last = k;
+            result.occurrences = 1;
+        } else if (prefix == result.minimum) {
+            result.last = k;
+            result.occurrences++;
+        }
+    }
+    result.total = prefix;
+    return result;
+}
+
+/**
+ * Appends the result of the values following the first offset ones to
+ * result.
+ */
+void append_prefix_minimum(PrefixMinimum &result, const PrefixMinimum &tail,
+                           int offset) {
+    if (tail.occurrences > 0) {
+        if (result.occurrences == 0 || tail.minimum < result.minimum) {
+            result.minimum = tail.minimum;
+            result.first = offset + tail.first;
+            result.occurrences = 0;
+        }
+        if (tail.minimum == result.minimum) {
+            result.last = offset + tail.last;
+            result.occurrences += tail.occurrences;
+        }
+    }
+    result.total = tail.total;
+    result.scanned = offset + tail.scanned;
+    result.negativeTotal += tail.negativeTotal;
+}
+
+__attribute__((target("avx2"))) int first_at_least_avx2(const int *values,
+                                                        int count,
+                                                        int barrier) {
+    const __m256i limit = _mm256_set1_epi32(barrier - 1);
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m256i block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + k));
+        int mask = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(block, limit)));
+        if (mask != 0) {
+            return k + __builtin_ctz(mask);
+        }
+    }
+    for (; k < count; ++k) {
+        if (values[k] >= barrier) {
+            return k;
+        }
+    }
+    return count;
+}
+
+/** Inclusive prefix sum of the four 64 bit lanes of x. */
+__attribute__((target("avx2"))) __m256i prefix_sum_avx2(__m256i x) {
+    const __m256i zero = _mm256_setzero_si256();
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(
+               _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero,
+               0x03));
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(
+               _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero,
+               0x0F));
+    return x;
+}
+
+__attribute__((target("avx2"))) PrefixMinimum
+prefix_minimum_avx2(const int *values, int count, long start, int barrier) {
+    const int scanned = first_at_least_avx2(values, count, barrier);
+    const int vectorized = scanned & ~3;
+
+    // First pass: the minimum of all prefix sums.
+    __m256i carry = _mm256_set1_epi64x(start);
+    __m256i minimum = _mm256_set1_epi64x(LONG_MAX);
+    __m256i negative = _mm256_setzero_si256();
+    for (int k = 0; k < vectorized; k += 4) {
+        __m128i raw =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + k));
+        negative = _mm256_add_epi64(
+            negative,
+            _mm256_cvtepi32_epi64(_mm_min_epi32(raw, _mm_setzero_si128())));
+        __m256i block = _mm256_cvtepi32_epi64(raw);
+        __m256i prefix = _mm256_add_epi64(prefix_sum_avx2(block), carry);
+        minimum = _mm256_blendv_epi8(minimum, prefix,
+                                     _mm256_cmpgt_epi64(minimum, prefix));
+        carry = _mm256_permute4x64_epi64(prefix, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    alignas(32) long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), minimum);
+    PrefixMinimum result{start, LONG_MAX, -1, -1, 0, vectorized, 0};
+    result.minimum = std::min(std::min(lanes[0], lanes[1]),
+                              std::min(lanes[2], lanes[3]));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), negative);
+    result.negativeTotal = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    result.total = _mm256_extract_epi64(carry, 0);
+
+    // Second pass: where the minimum is attained.
+    if (vectorized > 0) {
+        const __m256i target = _mm256_set1_epi64x(result.minimum);
+        carry = _mm256_set1_epi64x(start);
+        for (int k = 0; k < vectorized; k += 4) {
+            __m256i block = _mm256_cvtepi32_epi64(_mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(values + k)));
+            __m256i prefix = _mm256_add_epi64(prefix_sum_avx2(block), carry);
+            int mask = _mm256_movemask_pd(
+                _mm256_castsi256_pd(_mm256_cmpeq_epi64(prefix, target)));
+            if (mask != 0) {
+                if (result.occurrences == 0) {
+                    result.first = k + __builtin_ctz(mask);
+                }
+                result.last = k + 31 - __builtin_clz(mask);
+                result.occurrences += __builtin_popcount(mask);
+            }
+            carry = _mm256_permute4x64_epi64(prefix, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+
+    append_prefix_minimum(result,
+                          prefix_minimum_scalar(values + vectorized,
+                                                scanned - vectorized,
+                                                result.total, INT_MAX),
+                          vectorized);
+    return result;
+}
+
+__attribute__((target("avx512f"))) int
+first_at_least_avx512(const int *values, int count, int barrier) {
+    const __m512i limit = _mm512_set1_epi32(barrier);
+    for (int k = 0; k < count; k += 16) {
+        __mmask16 inRange =
+            count - k >= 16 ? 0xFFFF : (__mmask16)((1u << (count - k)) - 1);
+        __m512i block = _mm512_maskz_loadu_epi32(inRange, values + k);
+        __mmask16 mask = _mm512_mask_cmpge_epi32_mask(inRange, block, limit);
+        if (mask != 0) {
+            return k + __builtin_ctz(mask);
+        }
+    }
+    return count;
+}
+
+/** Inclusive prefix sum of the eight 64 bit lanes of x. */
+__attribute__((target("avx512f"))) __m512i prefix_sum_avx512(__m512i x) {
+    const __m512i zero = _mm512_setzero_si512();
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 7));
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 6));
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 4));
+    return x;
+}
+
+__attribute__((target("avx512f"))) PrefixMinimum
+prefix_minimum_avx512(const int *values, int count, long start, int barrier) {
+    const int scanned = first_at_least_avx512(values, count, barrier);
+    const int vectorized = scanned & ~7;
+    const __m512i last = _mm512_set1_epi64(7);
+
+    // First pass: the minimum of all prefix sums.
+    __m512i carry = _mm512_set1_epi64(start);
+    __m512i minimum = _mm512_set1_epi64(LONG_MAX);
+    __m512i negative = _mm512_setzero_si512();
+    for (int k = 0; k < vectorized; k += 8) {
+        __m512i block = _mm512_cvtepi32_epi64(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + k)));
+        negative = _mm512_add_epi64(
+            negative, _mm512_min_epi64(block, _mm512_setzero_si512()));
+        __m512i prefix = _mm512_add_epi64(prefix_sum_avx512(block), carry);
+        minimum = _mm512_min_epi64(minimum, prefix);
+        carry = _mm512_permutexvar_epi64(last, prefix);
+    }
+
+    PrefixMinimum result{start, LONG_MAX, -1, -1, 0, vectorized, 0};
+    result.minimum = _mm512_reduce_min_epi64(minimum);
+    result.negativeTotal = _mm512_reduce_add_epi64(negative);
+    result.total = _mm_cvtsi128_si64(_mm512_castsi512_si128(carry));
+
+    // Second pass: where the minimum is attained.
+    if (vectorized > 0) {
+        const __m512i target = _mm512_set1_epi64(result.minimum);
+        carry = _mm512_set1_epi64(start);
+        for (int k = 0; k < vectorized; k += 8) {
+            __m512i block = _mm512_cvtepi32_epi64(_mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(values + k)));
+            __m512i prefix = _mm512_add_epi64(prefix_sum_avx512(block), carry);
+            int mask = _mm512_cmpeq_epi64_mask(prefix, target);
+            if (mask != 0) {
+                if (result.occurrences == 0) {
+                    result.first = k + __builtin_ctz(mask);
+                }
+                result.last = k + 31 - __builtin_clz(mask);
+                result.occurrences += __builtin_popcount(mask);
+            }
+            carry = _mm512_permutexvar_epi64(last, prefix);
+        }
+    }
+
+    append_prefix_minimum(result,
+                          prefix_minimum_scalar(values + vectorized,
+                                                scanned - vectorized,
+                                                result.total, INT_MAX),
+                          vectorized);
+    return result;
+}
+
+} // namespace
+
+const std::vector<crossing_kernels_detail::KernelSet> &
+crossing_kernels_detail::kernel_sets() {
+    static const std::vector<KernelSet> sets = [] {
+        __builtin_cpu_init();
+        return std::vector<KernelSet>{
+            {"scalar", true, sum_row_after_position_scalar, gather_row_scalar,
+             prefix_minimum_scalar},
+            {"avx2", static_cast<bool>(__builtin_cpu_supports("avx2")),
+             sum_row_after_position_avx2, gather_row_avx2,
+             prefix_minimum_avx2},
+            {"avx512f", static_cast<bool>(__builtin_cpu_supports("avx512f")),
+             sum_row_after_position_avx512, gather_row_avx512,
+             prefix_minimum_avx512},
+        };
+    }();
+    return sets;
+}
+
+namespace {
+
+const crossing_kernels_detail::KernelSet &fastest_kernels() {
+    const auto &sets = crossing_kernels_detail::kernel_sets();
+    for (auto it = sets.rbegin(); it != sets.rend(); ++it) {
+        if (it->supported) {
+            return *it;
+        }
+    }
+    return sets.front();
+}
+
+const auto sum_row_after_position_impl =
+    fastest_kernels().sum_row_after_position;
+const auto gather_row_impl = fastest_kernels().gather_row;
+const auto prefix_minimum_impl = fastest_kernels().prefix_minimum;
+
+} // namespace
+
+long sum_row_after_position(const int *row, const int *vertex_to_position,
+                            int size, int position) {
+    return sum_row_after_position_impl(row, vertex_to_position, size, position);
+}
+
+void gather_row(const int *row, const int *vertices, int step, int count,
+                int sign, int *out) {
+    gather_row_impl(row, vertices, step, count, sign, out);
+}
+
+PrefixMinimum prefix_minimum(const int *values, int count, long start,
+                             int barrier) {
+    return prefix_minimum_impl(values, count, start, barrier);
+}
@@ -0,0 +1,77 @@
+#ifndef PACE2024_CROSSING_KERNELS_HPP
+#define PACE2024_CROSSING_KERNELS_HPP
+
+#include <vector>
+
+/**
+ * Hot loops over rows of the crossing matrix. Every kernel has a scalar
+ * implementation and AVX2 / AVX-512 implementations, the fastest one
+ * supported by the CPU is selected at runtime.
+ */
+
+/**
+ * @return the sum of row[v] over all v in [0, size) with
+ * vertex_to_position[v] > position.
+ */
+long sum_row_after_position(const int *row, const int *vertex_to_position,
+                            int size, int position);
+
+/**
+ * Gathers the entries of row in the order of the given vertices, i.e.
+ * out[k] = sign * row[vertices[k * step]] for k in [0, count). step must be 1
+ * or -1 and sign must be 1 or -1.
+ */
+void gather_row(const int *row, const int *vertices, int step, int count,
+                int sign, int *out);
+
+/**
+ * Result of prefix_minimum. Positions are indices into the scanned values.
+ */
+struct PrefixMinimum {
+    /** start plus the sum of all scanned values. */
+    long total;
+    /** The smallest prefix sum, only meaningful if occurrences > 0. */
+    long minimum;
+    /** First and last index at which the prefix sum equals minimum. */
+    int first;
+    int last;
+    /** Number of indices at which the prefix sum equals minimum. */
+    int occurrences;
+    /** Number of values before the first one that is >= barrier. */
+    int scanned;
+    /** Sum of the negative scanned values. */
+    long negativeTotal;
+};
+
+/**
+ * Computes the prefix sums start + values[0] + ... + values[k] for all k
+ * before the first value that is >= barrier and returns the smallest one
+ * together with where it is attained. The sums are computed in 64 bit.
+ * Also sums up the negative values, which bounds how much the prefix sums can
+ * still decrease.
+ */
+PrefixMinimum prefix_minimum(const int *values, int count, long start,
+                             int barrier);
+
+namespace crossing_kernels_detail {
+
+/** The implementations of the kernels for one instruction set. */
+struct KernelSet {
+    const char *instructionSet;
+    /** Whether the CPU supports the instruction set. */
+    bool supported;
+    long (*sum_row_after_position)(const int *, const int *, int, int);
+    void (*gather_row)(const int *, const int *, int, int, int, int *);
+    PrefixMinimum (*prefix_minimum)(const int *, int, long, int);
+};
+
+/**
+ * @return the implementations for all instruction sets, the scalar one
+ * first. The functions above use the last supported one. Exposed so that
+ * tests can compare all of them.
+ */
+const std::vector<KernelSet> &kernel_sets();
+
+} // namespace crossing_kernels_detail
+
+#endif // PACE2024_CROSSING_KERNELS_HPP
@@ -3,10 +3,13 @@
 //
 
 #include "crossing_matrix.hpp"
+#include "crossing_kernels.hpp"
 #include "order.hpp"
 #include "pace_graph.hpp"
+#include "parallel.hpp"
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 
 bool CrossingMatrix::set_a_lt_b(int a, int b) {
 
@@ -14,9 +17,14 @@ bool CrossingMatrix::set_a_lt_b(int a, int b) {
         return false;
     }
 
+    add_overlay_constraint(a);
+    add_overlay_constraint(b);
     matrix[b][a] += FIXED;
-    matrix_diff[b][a] += FIXED;
-    matrix_diff[a][b] -= FIXED;
+    add_to_diff(b, a, FIXED);
+    add_to_diff(a, b, -FIXED);
+    if (a < b) {
+        lower_triangle_sum += FIXED;
+    }
 
     return true;
 }
@@ -26,12 +34,109 @@ void CrossingMatrix::unset_a_lt_b(int a, int b) {
         return;
     }
     matrix[b][a] -= FIXED;
-    matrix_diff[b][a] -= FIXED;
-    matrix_diff[a][b] += FIXED;
+    add_to_diff(b, a, -FIXED);
+    add_to_diff(a, b, FIXED);
+    if (a < b) {
+        lower_triangle_sum -= FIXED;
+    }
+    remove_overlay_constraint(a);
+    remove_overlay_constraint(b);
 }
 
 bool CrossingMatrix::lt(int a, int b) { return matrix[b][a] >= FIXED; }
 
+long CrossingMatrix::count_crossings(
+    const std::vector<int> &vertex_to_position) const {
+    const int size = vertex_to_position.size();
+    const int *positions = vertex_to_position.data();
+
+    // The crossings are the lower triangle sum plus matrix_diff[u][v] for
+    // every u < v with u placed before v, so only the upper triangle of
+    // matrix_diff has to be read.
+    auto sumUpperRow = [&](int u) {
+        return sum_row_after_position(matrix_diff[u] + u + 1,
+                                      positions + u + 1, size - u - 1,
+                                      positions[u]);
+    };
+
+    // Row u and row size - 1 - u together have size - 1 entries, so pairing
+    // them balances the work of the threads. Every thread should at least
+    // handle ~4M entries.
+    const int pairs = (size + 1) / 2;
+    int minPairsPerThread = std::max(1, (1 << 22) / std::max(1, size));
+    std::vector<long> crossingsPerThread(number_of_threads(), 0);
+
+    parallel_for(0, pairs, minPairsPerThread, [&](int from, int to, int thread) {
+        long crossings = 0;
+        for (int u = from; u < to; ++u) {
+            crossings += sumUpperRow(u);
+            if (size - 1 - u != u) {
+                crossings += sumUpperRow(size - 1 - u);
+            }
+        }
+        crossingsPerThread[thread] = crossings;
+    });
+
+    return lower_triangle_sum + std::accumulate(crossingsPerThread.begin(),
+                                                crossingsPerThread.end(), 0L);
+}
+
+void CrossingMatrix::init_lower_triangle_sum() {
+    lower_triangle_sum = 0;
+    for (int v = 0; v < matrix.size(); ++v) {
+        for (int u = 0; u < v; ++u) {
+            lower_triangle_sum += matrix[v][u];
+        }
+    }
+}
+
+void CrossingMatrix::init_positive_diff_sum() {
+    positive_diff_sum.assign(matrix_diff.size(), 0);
+    for (int v = 0; v < matrix_diff.size(); ++v) {
+        for (int u = 0; u < matrix_diff.size(); ++u) {
+            positive_diff_sum[v] += std::max(matrix_diff[v][u], 0);
+        }
+    }
+}
+
+void CrossingMatrix::add_to_diff(int v, int u, int value) {
+    int &diff = matrix_diff[v][u];
+    positive_diff_sum[v] -= std::max(diff, 0);
+    diff += value;
+    positive_diff_sum[v] += std::max(diff, 0);
+}
+
+void CrossingMatrix::add_overlay_constraint(int v) {
+    if (overlay_base == nullptr) {
+        return;
+    }
+    if (row_is_shared[v]) {
+        const int size = matrix.size();
+        int *row = new int[size];
+        int *diff_row = new int[size];
+        std::copy(matrix[v], matrix[v] + size, row);
+        std::copy(matrix_diff[v], matrix_diff[v] + size, diff_row);
+        matrix[v] = row;
+        matrix_diff[v] = diff_row;
+        row_is_shared[v] = false;
+    }
+    overlay_constraints[v]++;
+}
+
+void CrossingMatrix::remove_overlay_constraint(int v) {
+    if (overlay_base == nullptr) {
+        return;
+    }
+    // Unsetting restored the values of the base, so the copy can be dropped.
+    if (--overlay_constraints[v] == 0) {
+        delete[] matrix[v];
+        delete[] matrix_diff[v];
+        matrix[v] = overlay_base->matrix[v];
+        matrix_diff[v] = overlay_base->matrix_diff[v];
+        row_is_shared[v] = true;
+    }
+}
+
 bool CrossingMatrix::comparable(int a, int b) {
     return lt(a, b) || lt(b, a) || a == b;
 }
@@ -65,6 +170,8 @@ void CrossingMatrix::init_crossing_matrix(PaceGraph &graph) {
         }
     }
 
+    init_lower_triangle_sum();
+    init_positive_diff_sum();
     is_init = true;
 }
 void CrossingMatrix::remove_free_vertices(
@@ -96,6 +203,22 @@ void CrossingMatrix::remove_free_vertices(
         matrix.erase(matrix.begin() + vertices_to_remove[i]);
         matrix_diff.erase(matrix_diff.begin() + vertices_to_remove[i]);
     }
+
+    init_lower_triangle_sum();
+    init_positive_diff_sum();
+}
+
+void CrossingMatrix::init_overlay(const CrossingMatrix &base) {
+    clean();
+    matrix = base.matrix;
+    matrix_diff = base.matrix_diff;
+    lower_triangle_sum = base.lower_triangle_sum;
+    positive_diff_sum = base.positive_diff_sum;
+
+    overlay_base = &base;
+    row_is_shared.assign(matrix.size(), true);
+    overlay_constraints.assign(matrix.size(), 0);
+    is_init = true;
 }
 
 bool CrossingMatrix::is_initialized() { return is_init; }
@@ -107,12 +230,20 @@ bool CrossingMatrix::can_initialized(PaceGraph &graph) {
 void CrossingMatrix::clean() {
     is_init = false;
     for (int i = 0; i < matrix.size(); i++) {
+        if (overlay_base != nullptr && row_is_shared[i]) {
+            continue;
+        }
         delete[] matrix[i];
         delete[] matrix_diff[i];
     }
 
     matrix.clear();
     matrix_diff.clear();
+    lower_triangle_sum = 0;
+    positive_diff_sum.clear();
+    overlay_base = nullptr;
+    row_is_shared.clear();
+    overlay_constraints.clear();
 }
 CrossingMatrix::~CrossingMatrix() { clean(); }
 
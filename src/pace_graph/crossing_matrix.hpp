@@ -17,6 +17,27 @@ class CrossingMatrix {
   private:
     bool is_init = false;
 
+    /** Sum of matrix[v][u] over all u < v. */
+    long lower_triangle_sum = 0;
+
+    /** Sum of max(matrix_diff[v][u], 0) over all u for every v. */
+    std::vector<long> positive_diff_sum;
+
+    /**
+     * Only set for overlays (see init_overlay): the matrix whose rows are
+     * shared, the rows that are still shared and the number of constraints
+     * that the overlay added to every row.
+     */
+    const CrossingMatrix *overlay_base = nullptr;
+    std::vector<char> row_is_shared;
+    std::vector<int> overlay_constraints;
+
+    void init_lower_triangle_sum();
+    void init_positive_diff_sum();
+    void add_to_diff(int v, int u, int value);
+    void add_overlay_constraint(int v);
+    void remove_overlay_constraint(int v);
+
   public:
     std::vector<int *> matrix;
     std::vector<int *> matrix_diff;
@@ -33,7 +54,29 @@ class CrossingMatrix {
 
     bool lt(int a, int b);
 
+    /**
+     * Counts the crossings of the order given by vertex_to_position. Streams
+     * over the rows with SIMD and splits the rows over threads for large
+     * matrices.
+     */
+    long count_crossings(const std::vector<int> &vertex_to_position) const;
+
+    /**
+     * @return the sum of the positive entries of matrix_diff[v]. Bounds how
+     * much moving v can improve an order.
+     */
+    long get_positive_diff_sum(int v) const { return positive_diff_sum[v]; }
+
     void init_crossing_matrix(PaceGraph &graph);
+
+    /**
+     * Turns this matrix into an overlay of base: it shares the rows of base
+     * until set_a_lt_b changes them, then the affected rows are copied. When
+     * all constraints of a row are unset again, the row is shared again. This
+     * way several threads can add different constraints to the same matrix.
+     * base must not change while the overlay is in use.
+     */
+    void init_overlay(const CrossingMatrix &base);
     bool can_initialized(PaceGraph &graph);
     bool is_initialized();
 
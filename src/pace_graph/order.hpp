@@ -4,6 +4,7 @@
 // #include "pace_graph.hpp"
 
 #include "pace_graph.hpp"
+#include "random.hpp"
 #include "segment_tree.hpp"
 #include <algorithm>
 #include <iostream>
@@ -13,6 +14,42 @@
 #include <vector>
 
 class Order {
+  private:
+    /**
+     * Matrix used to keep crossings up to date. nullptr if the crossings of
+     * this order are not tracked.
+     */
+    CrossingMatrix *tracked_matrix = nullptr;
+    long crossings = 0;
+
+    /**
+     * Places vertex at new_position and shifts the vertices in between.
+     */
+    void shift_vertex(int vertex, int new_position) {
+        int old_position = vertex_to_position[vertex];
+
+        // Check if we need to shift vertices forward or backward.
+        if (old_position < new_position) {
+            // Move each vertex one position back, from old_position + 1 to
+            // new_position.
+            for (int i = old_position; i < new_position; ++i) {
+                int next_vertex = position_to_vertex[i + 1];
+                position_to_vertex[i] = next_vertex;
+                vertex_to_position[next_vertex] = i;
+            }
+        } else if (old_position > new_position) {
+            // Move each vertex one position forward, from old_position - 1 to
+            // new_position.
+            for (int i = old_position; i > new_position; --i) {
+                int prev_vertex = position_to_vertex[i - 1];
+                position_to_vertex[i] = prev_vertex;
+                vertex_to_position[prev_vertex] = i;
+            }
+        }
+        // Place the vertex at its new position.
+        position_to_vertex[new_position] = vertex;
+        vertex_to_position[vertex] = new_position;
+    }
 
   public:
     // TODO(Lukas): These vectors should hold unsigned ints.
@@ -44,10 +81,92 @@ class Order {
         }
     }
 
+    /**
+     * Starts to keep track of the number of crossings of this order. Every
+     * following move_vertex, swap_by_vertices and permute updates the value
+     * returned by get_crossings() incrementally.
+     * @return false if the crossing matrix of the graph is not initialized. In
+     * that case the crossings are not tracked.
+     */
+    bool track_crossings(PaceGraph &graph) {
+        if (!graph.crossing.is_initialized()) {
+            tracked_matrix = nullptr;
+            return false;
+        }
+        tracked_matrix = &graph.crossing;
+        crossings = count_crossings(graph);
+        return true;
+    }
+
+    bool is_tracking_crossings() const { return tracked_matrix != nullptr; }
+
+    /**
+     * @return the cost change if vertex is moved from its current position to
+     * new_position, all other vertices keeping their relative order. Takes
+     * O(distance) time. Only valid if track_crossings was called before.
+     */
+    long move_cost_change(int vertex, int new_position) const {
+        int old_position = vertex_to_position[vertex];
+        const int *diff = tracked_matrix->matrix_diff[vertex];
+
+        long change = 0;
+        for (int i = new_position; i < old_position; ++i) {
+            change += diff[position_to_vertex[i]];
+        }
+        for (int i = old_position + 1; i <= new_position; ++i) {
+            change -= diff[position_to_vertex[i]];
+        }
+        return change;
+    }
+
+    /**
+     * @return the number of crossings of this order in O(1). Only valid if
+     * track_crossings was called before.
+     */
+    long get_crossings() const { return crossings; }
+
+    /**
+     * Commits a < b in the tracked crossing matrix (see
+     * CrossingMatrix::set_a_lt_b) and keeps the tracked crossings consistent
+     * with the changed matrix.
+     */
+    bool set_a_lt_b(int a, int b) {
+        bool changed = tracked_matrix->set_a_lt_b(a, b);
+        if (changed && vertex_to_position[b] < vertex_to_position[a]) {
+            crossings += FIXED;
+        }
+        return changed;
+    }
+
+    /**
+     * Reverts set_a_lt_b(a, b) and keeps the tracked crossings consistent.
+     */
+    void unset_a_lt_b(int a, int b) {
+        if (a != b && vertex_to_position[b] < vertex_to_position[a]) {
+            crossings -= FIXED;
+        }
+        tracked_matrix->unset_a_lt_b(a, b);
+    }
+
     void swap_by_vertices(const int v, const int u) {
         int pos1 = vertex_to_position[v];
         int pos2 = vertex_to_position[u];
 
+        if (tracked_matrix != nullptr && pos1 != pos2) {
+            int first = pos1 < pos2 ? v : u;
+            int second = pos1 < pos2 ? u : v;
+            const int *diff_first = tracked_matrix->matrix_diff[first];
+            const int *diff_second = tracked_matrix->matrix_diff[second];
+
+            long change = diff_second[first];
+            for (int i = std::min(pos1, pos2) + 1; i < std::max(pos1, pos2);
+                 ++i) {
+                int w = position_to_vertex[i];
+                change += diff_second[w] - diff_first[w];
+            }
+            crossings += change;
+        }
+
         vertex_to_position[v] = pos2;
         vertex_to_position[u] = pos1;
 
@@ -68,15 +187,7 @@ class Order {
         long crossings = 0;
 
         if (graph.crossing.is_initialized()) {
-            for (int i = 0; i < graph.size_free; i++) {
-                for (int j = i + 1; j < graph.size_free; j++) {
-                    int u = position_to_vertex[i];
-                    int v = position_to_vertex[j];
-                    crossings += graph.crossing.matrix[u][v];
-                }
-            }
-
-            return crossings;
+            return graph.crossing.count_crossings(vertex_to_position);
         }
 
         if (graph.size_free == 0) {
@@ -106,49 +217,60 @@ class Order {
         return crossings;
     }
 
+    /**
+     * Moves vertex to new_position, when the cost change of this move is
+     * already known (e.g. from sifting). This avoids recomputing it for the
+     * tracked crossings.
+     */
+    void move_vertex(int vertex, int new_position, long cost_change) {
+        if (tracked_matrix != nullptr) {
+            crossings += cost_change;
+        }
+        shift_vertex(vertex, new_position);
+    }
+
     void move_vertex(int vertex, int new_position) {
-        int old_position = vertex_to_position[vertex];
+        if (tracked_matrix != nullptr) {
+            crossings += move_cost_change(vertex, new_position);
+        }
+        shift_vertex(vertex, new_position);
+    }
 
-        // Check if we need to shift vertices forward or backward.
-        if (old_position < new_position) {
-            // Move each vertex one position back, from old_position + 1 to
-            // new_position.
-            for (int i = old_position; i < new_position; ++i) {
-                int next_vertex = position_to_vertex[i + 1];
-                position_to_vertex[i] = next_vertex;
-                vertex_to_position[next_vertex] = i;
-            }
-        } else if (old_position > new_position) {
-            // Move each vertex one position forward, from old_position - 1 to
-            // new_position.
-            for (int i = old_position; i > new_position; --i) {
-                int prev_vertex = position_to_vertex[i - 1];
-                position_to_vertex[i] = prev_vertex;
-                vertex_to_position[prev_vertex] = i;
-            }
+    /**
+     * Swaps the adjacent blocks of positions [first, middle) and
+     * [middle, last), when the cost change of this move is already known.
+     */
+    void swap_blocks(int first, int middle, int last, long cost_change) {
+        if (tracked_matrix != nullptr) {
+            crossings += cost_change;
+        }
+        std::rotate(position_to_vertex.begin() + first,
+                    position_to_vertex.begin() + middle,
+                    position_to_vertex.begin() + last);
+        for (int i = first; i < last; ++i) {
+            vertex_to_position[position_to_vertex[i]] = i;
         }
-        // Place the vertex at its new position.
-        position_to_vertex[new_position] = vertex;
-        vertex_to_position[vertex] = new_position;
     }
 
     /**
      * Randomly permutes the order.
      */
     void permute() {
-        std::random_device rd;
-        std::mt19937 g(rd());
-
         // Shuffle the position_to_vertex vector
-        std::shuffle(position_to_vertex.begin(), position_to_vertex.end(), g);
+        std::shuffle(position_to_vertex.begin(), position_to_vertex.end(),
+                     thread_rng());
 
         // Update the vertex_to_position vector to reflect the new positions
         for (size_t i = 0; i < position_to_vertex.size(); ++i) {
             vertex_to_position[position_to_vertex[i]] = i;
         }
+
+        if (tracked_matrix != nullptr) {
+            crossings = tracked_matrix->count_crossings(vertex_to_position);
+        }
     }
 
-    Order clone() { return Order(std::vector(position_to_vertex)); }
+    Order clone() { return *this; }
 
     std::unique_ptr<PaceGraph> reorderGraph(PaceGraph &graph) {
         std::vector<std::tuple<int, int>> new_edges;
@@ -163,10 +285,12 @@ class Order {
             }
         }
 
-        return std::make_unique<PaceGraph>(graph.size_fixed, graph.size_free,
-                                           new_edges, graph.fixed_real_names,
-                                           new_free_real_names,
-                                           graph.is_cutwidth_graph);
+        auto reordered = std::make_unique<PaceGraph>(
+            graph.size_fixed, graph.size_free, new_edges,
+            graph.fixed_real_names, new_free_real_names,
+            graph.is_cutwidth_graph);
+        reordered->cutwidth_positions = graph.cutwidth_positions;
+        return reordered;
     }
 };
 
@@ -48,6 +48,7 @@ PaceGraph PaceGraph::from_gr(std::istream &gr) {
     int b = 0;
     bool pfound = false;
     bool cutwidth = false;
+    std::vector<int> cutwidth_positions;
     std::vector<std::tuple<int, int>> edges;
 
     std::string line;
@@ -58,8 +59,15 @@ PaceGraph PaceGraph::from_gr(std::istream &gr) {
             sscanf(line.c_str(), "p ocr %d %d", &a, &b);
             if (spaceCount == 5) {
                 cutwidth = true;
-                for (int _ = 0; _ < a + b; _++) {
+                cutwidth_positions.assign(a + b + 1, 0);
+                for (int position = 0; position < a + b; position++) {
                     std::getline(gr, line);
+                    int v = std::stoi(line);
+                    if (v < 1 || v > a + b) {
+                        throw std::invalid_argument(
+                            "ERROR: Invalid vertex in cutwidth order.");
+                    }
+                    cutwidth_positions[v] = position;
                 }
             }
 
@@ -78,7 +86,12 @@ PaceGraph PaceGraph::from_gr(std::istream &gr) {
         }
     }
 
-    return PaceGraph(a, b, edges, cutwidth);
+    PaceGraph graph(a, b, edges, cutwidth);
+    if (cutwidth) {
+        graph.cutwidth_positions = std::make_shared<const std::vector<int>>(
+            std::move(cutwidth_positions));
+    }
+    return graph;
 }
 
 PaceGraph PaceGraph::from_file(std::string file_path) {
@@ -344,9 +357,11 @@ PaceGraph::induced_subgraphs_free(std::vector<int> free_nodes) {
         }
     }
 
-    return std::make_unique<PaceGraph>(fixedCount, free_nodes.size(), edges,
-                                       new_fixed_real_names,
-                                       new_free_real_names, is_cutwidth_graph);
+    auto subgraph = std::make_unique<PaceGraph>(
+        fixedCount, free_nodes.size(), edges, new_fixed_real_names,
+        new_free_real_names, is_cutwidth_graph);
+    subgraph->cutwidth_positions = cutwidth_positions;
+    return subgraph;
 }
 
 std::unique_ptr<PaceGraph>
@@ -386,9 +401,26 @@ PaceGraph::induced_subgraphs_fixed(std::vector<int> fixed_nodes) {
         }
     }
 
-    return std::make_unique<PaceGraph>(fixed_nodes.size(), freeCount, edges,
-                                       new_fixed_real_names,
-                                       new_free_real_names, is_cutwidth_graph);
+    auto subgraph = std::make_unique<PaceGraph>(
+        fixed_nodes.size(), freeCount, edges, new_fixed_real_names,
+        new_free_real_names, is_cutwidth_graph);
+    subgraph->cutwidth_positions = cutwidth_positions;
+    return subgraph;
+}
+
+std::vector<int> PaceGraph::cutwidth_order() const {
+    std::vector<int> order;
+    if (cutwidth_positions == nullptr) {
+        return order;
+    }
+    for (int v = 0; v < size_free; ++v) {
+        order.push_back(v);
+    }
+    const auto &positions = *cutwidth_positions;
+    std::sort(order.begin(), order.end(), [&](int u, int v) {
+        return positions[free_real_names[u]] < positions[free_real_names[v]];
+    });
+    return order;
 }
 
 std::tuple<int, int> PaceGraph::calculatingCrossingNumber(int u, int v) {
@@ -415,10 +447,21 @@ std::tuple<int, int> PaceGraph::calculatingCrossingNumber(int u, int v) {
             crossing_entries_v_u += i;
             j++;
         } else {
-            crossing_entries_u_v += j;
-            crossing_entries_v_u += i;
-            i++;
-            j++;
+            // Equal neighbors do not cross. Runs of them appear if the graph
+            // has multi-edges.
+            int value = u_neighbors[i];
+            int runU = 0;
+            int runV = 0;
+            while (i + runU < n && u_neighbors[i + runU] == value) {
+                runU++;
+            }
+            while (j + runV < m && v_neighbors[j + runV] == value) {
+                runV++;
+            }
+            crossing_entries_u_v += runU * j;
+            crossing_entries_v_u += runV * i;
+            i += runU;
+            j += runV;
         }
     }
 
@@ -427,6 +470,49 @@ std::tuple<int, int> PaceGraph::calculatingCrossingNumber(int u, int v) {
 
     return std::make_tuple(crossing_entries_u_v, crossing_entries_v_u);
 }
+void PaceGraph::crossing_row_sums(std::vector<long> &sums) {
+    // edgesLeftOf[a] is the number of edges whose fixed endpoint is left of a.
+    std::vector<long> edgesLeftOf(size_fixed + 1, 0);
+    for (const auto &neighbors : neighbors_free) {
+        for (int a : neighbors) {
+            edgesLeftOf[a + 1]++;
+        }
+    }
+    for (int a = 0; a < size_fixed; ++a) {
+        edgesLeftOf[a + 1] += edgesLeftOf[a];
+    }
+
+    sums.resize(size_free);
+    for (int u = 0; u < size_free; ++u) {
+        const auto &neighbors = neighbors_free[u];
+        long sum = 0;
+        int smallerNeighbors = 0;
+        for (int i = 0; i < neighbors.size(); ++i) {
+            // Edges of u itself do not cross.
+            if (i > 0 && neighbors[i] != neighbors[i - 1]) {
+                smallerNeighbors = i;
+            }
+            sum += edgesLeftOf[neighbors[i]] - smallerNeighbors;
+        }
+        sums[u] = sum;
+    }
+}
+
+std::unique_ptr<PaceGraph> PaceGraph::constraint_overlay() {
+    std::vector<std::tuple<int, int>> no_edges;
+    auto overlay =
+        std::make_unique<PaceGraph>(size_fixed, size_free, no_edges,
+                                    fixed_real_names, free_real_names,
+                                    is_cutwidth_graph);
+    overlay->neighbors_free = neighbors_free;
+    overlay->neighbors_fixed = neighbors_fixed;
+    overlay->lb = lb;
+    overlay->ub = ub;
+    overlay->cutwidth_positions = cutwidth_positions;
+    overlay->crossing.init_overlay(crossing);
+    return overlay;
+}
+
 bool PaceGraph::init_crossing_matrix_if_necessary() {
     if (!crossing.is_initialized()) {
         if (!crossing.can_initialized(*this)) {
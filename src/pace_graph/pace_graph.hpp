@@ -31,6 +31,12 @@ class PaceGraph {
     long lb = 0;
     long ub = 1000000000;
     bool is_cutwidth_graph = false;
+    /**
+     * Only set for cutwidth graphs: the position of every vertex in the
+     * linear order given in the input, indexed by real name. Shared by all
+     * subgraphs.
+     */
+    std::shared_ptr<const std::vector<int>> cutwidth_positions;
 
     long cost_through_deleted_nodes = 0;
 
@@ -98,6 +104,12 @@ class PaceGraph {
 
     std::string print_neighbors_fixed();
 
+    /**
+     * @return the free vertices sorted by their position in the cutwidth
+     * order of the input, or an empty vector if there is none
+     */
+    std::vector<int> cutwidth_order() const;
+
     int size() { return size_fixed + size_free; }
     int edge_count() const { return neighbors_free.size(); }
 
@@ -110,7 +122,24 @@ class PaceGraph {
 
     std::tuple<int, int> calculatingCrossingNumber(int u, int v);
 
+    /**
+     * Computes the crossings of every free vertex u with all other free
+     * vertices if u is placed left of them, i.e. the row sums of the crossing
+     * matrix without the fixed constraints. Takes O(m + size_fixed) time
+     * and does not need the crossing matrix.
+     * @param sums is resized to size_free
+     */
+    void crossing_row_sums(std::vector<long> &sums);
+
     bool init_crossing_matrix_if_necessary();
+
+    /**
+     * @return a copy of this graph whose crossing matrix is an overlay of the
+     * crossing matrix of this graph (see CrossingMatrix::init_overlay). The
+     * crossing matrix of this graph must be initialized and must not change
+     * while the copy is in use.
+     */
+    std::unique_ptr<PaceGraph> constraint_overlay();
 };
 
 #endif // PACE_GRAPH_HPP
@@ -0,0 +1,181 @@
+#ifndef PACE2024_PARALLEL_HPP
+#define PACE2024_PARALLEL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Number of threads the solvers may use. Defaults to the number of hardware
+ * threads.
+ */
+inline int &number_of_threads() {
+    static int threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    return threads;
+}
+
+inline void set_number_of_threads(int threads) {
+    number_of_threads() = std::max(1, threads);
+}
+
+namespace parallel_detail {
+/** True while the current thread runs a chunk of a parallel_for. */
+inline bool &inside_parallel_for() {
+    thread_local bool inside = false;
+    return inside;
+}
+} // namespace parallel_detail
+
+/**
+ * Number of threads a parallel_for started on the current thread may use.
+ * Nested parallel_for calls run sequentially, as all threads are busy already.
+ */
+inline int available_threads() {
+    return parallel_detail::inside_parallel_for() ? 1 : number_of_threads();
+}
+
+/**
+ * Splits [begin, end) into consecutive chunks of at least minChunkSize
+ * elements and calls f(from, to, threadIndex) for every chunk, each one on its
+ * own thread. The calling thread handles the first chunk. Runs sequentially
+ * if the range is too small to be split or if called from within another
+ * parallel_for.
+ */
+template <typename F>
+void parallel_for(int begin, int end, int minChunkSize, const F &f) {
+    int size = end - begin;
+    int threads =
+        std::min(available_threads(), std::max(1, size / minChunkSize));
+    if (threads <= 1) {
+        f(begin, end, 0);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) {
+        int from = begin + static_cast<long>(size) * t / threads;
+        int to = begin + static_cast<long>(size) * (t + 1) / threads;
+        workers.emplace_back([&f, from, to, t]() {
+            parallel_detail::inside_parallel_for() = true;
+            f(from, to, t);
+        });
+    }
+    parallel_detail::inside_parallel_for() = true;
+    f(begin, begin + size / threads, 0);
+    parallel_detail::inside_parallel_for() = false;
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Threads that stay alive between parallel_for calls, for loops that split
+ * many small pieces of work (a few milliseconds each), where starting
+ * and joining threads for every piece would cost more than it saves.
+ * The worker threads wait on a condition variable between calls.
+ */
+class ThreadTeam {
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    /** Called with the index of the thread, set for every parallel_for. */
+    std::function<void(int)> task;
+    long generation = 0;
+    int running = 0;
+    bool stopping = false;
+
+    void work(int thread) {
+        parallel_detail::inside_parallel_for() = true;
+        long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                started.wait(lock,
+                             [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            task(thread);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                running--;
+            }
+            finished.notify_one();
+        }
+    }
+
+  public:
+    /**
+     * Starts available_threads() - 1 worker threads, the calling thread is
+     * the last member of the team.
+     */
+    ThreadTeam() {
+        int threads = available_threads();
+        workers.reserve(threads - 1);
+        for (int t = 1; t < threads; ++t) {
+            workers.emplace_back([this, t]() { work(t); });
+        }
+    }
+
+    ~ThreadTeam() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        started.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadTeam(const ThreadTeam &) = delete;
+    ThreadTeam &operator=(const ThreadTeam &) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    /**
+     * Like the free parallel_for, but runs the chunks on the threads of
+     * the team. Must be called from the thread that created the team.
+     */
+    template <typename F>
+    void parallel_for(int begin, int end, int minChunkSize, const F &f) {
+        int size = end - begin;
+        int threads = std::min(this->size(), std::max(1, size / minChunkSize));
+        if (threads <= 1) {
+            f(begin, end, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = [&f, begin, size, threads](int t) {
+                if (t < threads) {
+                    f(begin + static_cast<long>(size) * t / threads,
+                      begin + static_cast<long>(size) * (t + 1) / threads, t);
+                }
+            };
+            running = static_cast<int>(workers.size());
+            generation++;
+        }
+        started.notify_all();
+
+        parallel_detail::inside_parallel_for() = true;
+        f(begin, begin + size / threads, 0);
+        parallel_detail::inside_parallel_for() = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return running == 0; });
+    }
+};
+
+#endif // PACE2024_PARALLEL_HPP
@@ -0,0 +1,77 @@
+#include "radix_sort.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr int DIGIT_BITS = 8;
+constexpr int BUCKETS = 1 << DIGIT_BITS;
+constexpr int PASSES = 64 / DIGIT_BITS;
+
+/** Maps doubles to unsigned integers with the same order. */
+uint64_t order_preserving_bits(double key) {
+    if (std::isnan(key)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    // -0.0 and 0.0 are equal.
+    key += 0.0;
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits >> 63 ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+} // namespace
+
+void RadixSorter::sort_indices(const std::vector<double> &keys,
+                               std::vector<int> &indices) {
+    indices.resize(keys.size());
+    for (int i = 0; i < indices.size(); ++i) {
+        indices[i] = i;
+    }
+    sort_by(keys, indices);
+}
+
+void RadixSorter::sort_by(const std::vector<double> &keys,
+                          std::vector<int> &indices) {
+    const int size = indices.size();
+    bits.resize(size);
+    bitsBuffer.resize(size);
+    indicesBuffer.resize(size);
+
+    // Histograms of all passes in one sweep.
+    std::vector<std::array<int, BUCKETS>> counts(PASSES);
+    for (auto &count : counts) {
+        count.fill(0);
+    }
+    for (int i = 0; i < size; ++i) {
+        bits[i] = order_preserving_bits(keys[indices[i]]);
+        for (int pass = 0; pass < PASSES; ++pass) {
+            counts[pass][(bits[i] >> (pass * DIGIT_BITS)) & (BUCKETS - 1)]++;
+        }
+    }
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        auto &count = counts[pass];
+        int shift = pass * DIGIT_BITS;
+        if (size == 0 || count[(bits[0] >> shift) & (BUCKETS - 1)] == size) {
+            continue;
+        }
+
+        int offset = 0;
+        for (int &bucket : count) {
+            int bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+        for (int i = 0; i < size; ++i) {
+            int target = count[(bits[i] >> shift) & (BUCKETS - 1)]++;
+            bitsBuffer[target] = bits[i];
+            indicesBuffer[target] = indices[i];
+        }
+        bits.swap(bitsBuffer);
+        indices.swap(indicesBuffer);
+    }
+}
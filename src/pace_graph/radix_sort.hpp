@@ -0,0 +1,33 @@
+#ifndef PACE2024_RADIX_SORT_HPP
+#define PACE2024_RADIX_SORT_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Stable LSD radix sort by double keys, 8 bits per pass. Passes in which all
+ * keys have the same digit are skipped, so keys of a small range (e.g.
+ * positions) need only a few passes. The buffers are kept between calls.
+ */
+class RadixSorter {
+  private:
+    std::vector<uint64_t> bits;
+    std::vector<uint64_t> bitsBuffer;
+    std::vector<int> indicesBuffer;
+
+  public:
+    /**
+     * Fills indices with 0, ..., keys.size() - 1 sorted by keys. Equal keys
+     * keep their index order, NaN keys come last.
+     */
+    void sort_indices(const std::vector<double> &keys,
+                      std::vector<int> &indices);
+
+    /**
+     * Stably sorts indices by their keys. Sorting by a secondary key first
+     * and then by the primary key sorts lexicographically.
+     */
+    void sort_by(const std::vector<double> &keys, std::vector<int> &indices);
+};
+
+#endif // PACE2024_RADIX_SORT_HPP
@@ -0,0 +1,157 @@
+#ifndef PACE2024_RANDOM_HPP
+#define PACE2024_RANDOM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/**
+ * xoshiro256** by Blackman and Vigna (https://prng.di.unimi.it/). Much faster
+ * than std::mt19937 with a 32 byte state. Satisfies
+ * UniformRandomBitGenerator, so it can be used with std::shuffle and the
+ * std distributions.
+ */
+class Xoshiro256 {
+  private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+  public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        // Expand the seed with splitmix64 as recommended by the authors.
+        for (auto &s : state) {
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    /**
+     * @return a uniformly distributed number in [0, n) (Lemire's method
+     * without the rejection step, the bias is negligible for our sizes).
+     */
+    uint32_t next_below(uint32_t n) {
+        return static_cast<uint32_t>(((*this)() >> 32) * n >> 32);
+    }
+
+    /**
+     * @return a uniformly distributed number in [0, 1).
+     */
+    double next_double() { return ((*this)() >> 11) * 0x1.0p-53; }
+};
+
+namespace random_detail {
+inline std::atomic<uint64_t> seed{std::random_device{}()};
+inline std::atomic<uint64_t> seed_generation{0};
+inline std::atomic<uint64_t> next_stream{0};
+} // namespace random_detail
+
+/**
+ * @return a generator for the given stream. Different streams of the same
+ * seed are independent, e.g. use one stream per worker of a parallel
+ * algorithm to stay reproducible independent of the scheduling.
+ */
+inline Xoshiro256 make_rng(uint64_t stream) {
+    return Xoshiro256(random_detail::seed * 0x9e3779b97f4a7c15 + stream);
+}
+
+namespace random_detail {
+class ThreadGenerator {
+  public:
+    uint64_t generation = seed_generation;
+    Xoshiro256 rng = make_rng(next_stream++);
+};
+
+inline ThreadGenerator &thread_generator() {
+    thread_local ThreadGenerator generator;
+    return generator;
+}
+} // namespace random_detail
+
+/**
+ * Sets the seed of all random generators. The calling thread gets stream 0,
+ * generators of other threads that already exist are reseeded on their next
+ * use. Runs with the same seed are reproducible with one thread. With more
+ * threads, workers have to draw from a ThreadRngScope or generators of their
+ * own, and algorithms whose workers exchange results while they run (e.g.
+ * the islands of GeneticHeuristic) still depend on the timing.
+ */
+inline void set_random_seed(uint64_t seed) {
+    random_detail::seed = seed;
+    random_detail::next_stream = 1;
+    uint64_t generation = ++random_detail::seed_generation;
+
+    auto &generator = random_detail::thread_generator();
+    generator.generation = generation;
+    generator.rng = make_rng(0);
+}
+
+inline uint64_t get_random_seed() { return random_detail::seed; }
+
+/**
+ * @return the generator of the calling thread. Threads other than the one
+ * that set the seed are assigned streams in the order in which they first
+ * ask for a generator, see ThreadRngScope for workers.
+ */
+inline Xoshiro256 &thread_rng() {
+    auto &generator = random_detail::thread_generator();
+    uint64_t currentGeneration =
+        random_detail::seed_generation.load(std::memory_order_relaxed);
+    if (generator.generation != currentGeneration) {
+        generator.generation = currentGeneration;
+        generator.rng = make_rng(random_detail::next_stream++);
+    }
+    return generator.rng;
+}
+
+/**
+ * Replaces the generator of the calling thread by the given stream while it
+ * lives. A worker of a parallel_for that uses thread_rng (directly or e.g.
+ * through local_search) opens one with a stream drawn by the caller before
+ * the loop, so that its random numbers do not depend on the thread that runs
+ * it.
+ */
+class ThreadRngScope {
+  private:
+    Xoshiro256 saved;
+
+  public:
+    explicit ThreadRngScope(uint64_t stream) : saved(thread_rng()) {
+        thread_rng() = make_rng(stream);
+    }
+    ~ThreadRngScope() { thread_rng() = saved; }
+
+    ThreadRngScope(const ThreadRngScope &) = delete;
+    ThreadRngScope &operator=(const ThreadRngScope &) = delete;
+};
+
+#endif // PACE2024_RANDOM_HPP
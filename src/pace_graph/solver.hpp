@@ -2,13 +2,17 @@
 #define SOLVER_HPP
 
 #include "../data_reduction/data_reduction_rules.hpp"
-#include "../heuristic_solver/mean_position_heuristic.hpp"
+#include "../heuristic_solver/portfolio.hpp"
+#include "cancellation.hpp"
+#include "config.hpp"
 #include "directed_graph.hpp"
 #include "order.hpp"
 #include "pace_graph.hpp"
+#include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstring>
+#include <limits>
 
 enum ReorderType { REORDER_NONE, REORDER_HEURISTIC, REORDER_FIXED_NODE_SET };
 
@@ -21,7 +25,12 @@ template <typename T> class Solver {
     std::chrono::milliseconds time_limit_for_part;
     ReorderType reorderNodes;
     bool initUB;
-    static inline volatile bool got_signal = false;
+    static inline std::atomic<bool> got_signal{false};
+
+    /** Cancelled at the end of the time for the current part or at SIGTERM. */
+    CancellationToken part_token;
+    /** Flag of part_token, so that the signal handler can set it directly. */
+    static inline std::atomic<std::atomic<bool> *> current_part_flag{nullptr};
 
   protected:
     double percentage_for_this_part;
@@ -33,7 +42,14 @@ template <typename T> class Solver {
     virtual T run(PaceGraph &graph) = 0;
 
   public:
-    static void term(int _) { got_signal = true; }
+    static void term(int _) {
+        got_signal.store(true, std::memory_order_relaxed);
+        std::atomic<bool> *flag = current_part_flag.load();
+        if (flag != nullptr) {
+            flag->store(true, std::memory_order_relaxed);
+        }
+        cancel_all_tokens();
+    }
 
     Solver(std::chrono::milliseconds limit = std::chrono::milliseconds::max(),
            ReorderType reorderNodes = REORDER_NONE, bool initUB = true)
@@ -48,6 +64,8 @@ template <typename T> class Solver {
         sigaction(SIGTERM, &action, NULL);
     }
 
+    ~Solver() { current_part_flag = nullptr; }
+
     void solve(PaceGraph &graph) {
         std::tuple<std::vector<std::unique_ptr<PaceGraph>>, std::vector<int>>
             val = graph.splitGraphs();
@@ -58,6 +76,12 @@ template <typename T> class Solver {
 
         std::vector<T> results;
 
+        CancellationToken run_token =
+            time_limit == std::chrono::milliseconds::max()
+                ? CancellationToken::with_deadline(
+                      std::chrono::steady_clock::time_point::max())
+                : CancellationToken::with_deadline(start_time + time_limit);
+
         // solve all nodes with <= 2 free nodes directly
         for (const auto &g : splittedGraphs) {
             if (g->size_free <= 2) {
@@ -86,22 +110,20 @@ template <typename T> class Solver {
             }
 
             if (reorderNodes == REORDER_HEURISTIC || initUB) {
+                // The reduction rules need the crossing matrix anyway, and
+                // greedy insertion only runs with it. A reordered graph
+                // would need a new one.
+                if (reorderNodes != REORDER_HEURISTIC) {
+                    g->init_crossing_matrix_if_necessary();
+                }
 
-                MeanPositionParameter meanPositionParameter;
-                auto st = std::chrono::steady_clock::now();
-                MeanPositionSolver meanPositionSolver(
-                    [this, st](int it) {
-                        auto current_time = std::chrono::steady_clock::now();
-                        auto diff = current_time - st;
-                        if (diff > std::chrono::milliseconds(5000)) {
-                            return false;
-                        }
-
-                        return it == 0;
-                    },
-                    meanPositionParameter);
-
-                auto order = meanPositionSolver.solve(*g);
+                PortfolioParameter portfolioParameter;
+                portfolioParameter.load(solver_config());
+                Order order =
+                    initial_orders(*g, portfolioParameter,
+                                   CancellationToken::with_timeout(
+                                       std::chrono::seconds(5), run_token))
+                        .front();
                 long ub = order.count_crossings(*g);
 
                 if (reorderNodes == REORDER_HEURISTIC) {
@@ -131,7 +153,7 @@ template <typename T> class Solver {
             }
 
             start_time_for_part = std::chrono::steady_clock::now();
-            apply_reduction_rules(*g);
+            apply_reduction_rules(*g, run_token);
 
             auto msLeft = time_limit -
                           std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -145,11 +167,23 @@ template <typename T> class Solver {
             percentage_for_this_part =
                 static_cast<double>(g->size_free) / sizeForAllUpcomingSegments;
 
-            double newTimeLimitMs = msLeft.count() * percentage_for_this_part;
+            // Without a time limit the limit for the part does not fit into
+            // an int.
+            double newTimeLimitMs =
+                std::min(msLeft.count() * percentage_for_this_part,
+                         static_cast<double>(std::numeric_limits<int>::max()));
 
             time_limit_for_part =
                 std::chrono::milliseconds(static_cast<int>(newTimeLimitMs));
 
+            current_part_flag = nullptr;
+            part_token = CancellationToken::with_deadline(
+                start_time_for_part + time_limit_for_part, run_token);
+            current_part_flag = part_token.flag();
+            if (got_signal) {
+                part_token.cancel();
+            }
+
             results.push_back(run(*g));
             g->crossing.clean();
         }
@@ -163,10 +197,23 @@ template <typename T> class Solver {
                   << "ms" << std::endl;
     }
 
-    bool has_time_left() const {
-        return std::chrono::steady_clock::now() - start_time_for_part <
-                   time_limit_for_part &&
-               !got_signal;
+    bool has_time_left() const { return !part_token.is_cancelled(); }
+
+    /**
+     * @return the token that is cancelled when the time for the current part
+     * is over.
+     */
+    const CancellationToken &cancellation() const { return part_token; }
+
+    /**
+     * @return a token that is cancelled once the given fraction of the time
+     * for the current part has passed.
+     */
+    CancellationToken cancellation_after(double percentage) const {
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            time_limit_for_part * percentage);
+        return CancellationToken::with_deadline(start_time_for_part + duration,
+                                                part_token);
     }
 
     double time_percentage_past() const {
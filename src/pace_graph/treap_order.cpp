@@ -0,0 +1,251 @@
+#include "treap_order.hpp"
+
+#include "random.hpp"
+
+#include <algorithm>
+
+TreapOrder::TreapOrder(int size) {
+    std::vector<int> identity(size);
+    for (int i = 0; i < size; ++i) {
+        identity[i] = i;
+    }
+    build(identity);
+}
+
+TreapOrder::TreapOrder(const std::vector<int> &position_to_vertex) {
+    build(position_to_vertex);
+}
+
+void TreapOrder::update(int node) {
+    subtree_size[node] = 1 + size_of(left[node]) + size_of(right[node]);
+    if (left[node] != NONE) {
+        parent[left[node]] = node;
+    }
+    if (right[node] != NONE) {
+        parent[right[node]] = node;
+    }
+}
+
+void TreapOrder::split(int node, int count, int &first, int &second) {
+    if (node == NONE) {
+        first = NONE;
+        second = NONE;
+        return;
+    }
+
+    if (size_of(left[node]) < count) {
+        split(right[node], count - size_of(left[node]) - 1, right[node],
+              second);
+        first = node;
+    } else {
+        split(left[node], count, first, left[node]);
+        second = node;
+    }
+    update(node);
+    parent[node] = NONE;
+}
+
+int TreapOrder::merge(int first, int second) {
+    if (first == NONE) {
+        return second;
+    }
+    if (second == NONE) {
+        return first;
+    }
+
+    if (priority[first] > priority[second]) {
+        right[first] = merge(right[first], second);
+        update(first);
+        return first;
+    }
+
+    left[second] = merge(first, left[second]);
+    update(second);
+    return second;
+}
+
+void TreapOrder::build(const std::vector<int> &position_to_vertex) {
+    const int n = position_to_vertex.size();
+    left.assign(n, NONE);
+    right.assign(n, NONE);
+    parent.assign(n, NONE);
+    subtree_size.assign(n, 1);
+    priority.resize(n);
+
+    auto &rng = thread_rng();
+    for (int i = 0; i < n; ++i) {
+        priority[i] = rng() >> 32;
+    }
+
+    // Standard O(n) construction of a cartesian tree: the stack holds the
+    // right spine of the tree built so far.
+    std::vector<int> stack;
+    for (int v : position_to_vertex) {
+        int last = NONE;
+        while (!stack.empty() && priority[stack.back()] < priority[v]) {
+            last = stack.back();
+            stack.pop_back();
+        }
+        left[v] = last;
+        if (!stack.empty()) {
+            right[stack.back()] = v;
+        }
+        stack.push_back(v);
+    }
+
+    root = stack.empty() ? NONE : stack.front();
+    if (root == NONE) {
+        return;
+    }
+
+    // Recompute subtree sizes and parents in post order.
+    std::vector<int> postOrder;
+    postOrder.reserve(n);
+    stack.assign(1, root);
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        postOrder.push_back(node);
+        if (left[node] != NONE) {
+            stack.push_back(left[node]);
+        }
+        if (right[node] != NONE) {
+            stack.push_back(right[node]);
+        }
+    }
+    for (int i = postOrder.size() - 1; i >= 0; --i) {
+        update(postOrder[i]);
+    }
+    parent[root] = NONE;
+}
+
+int TreapOrder::get_position(int vertex) const {
+    int position = size_of(left[vertex]);
+    int node = vertex;
+    while (parent[node] != NONE) {
+        int p = parent[node];
+        if (right[p] == node) {
+            position += size_of(left[p]) + 1;
+        }
+        node = p;
+    }
+    return position;
+}
+
+int TreapOrder::get_vertex(int position) const {
+    int node = root;
+    while (true) {
+        int leftSize = size_of(left[node]);
+        if (position < leftSize) {
+            node = left[node];
+        } else if (position == leftSize) {
+            return node;
+        } else {
+            position -= leftSize + 1;
+            node = right[node];
+        }
+    }
+}
+
+void TreapOrder::move_vertex(int vertex, int new_position) {
+    int old_position = get_position(vertex);
+    if (old_position == new_position) {
+        return;
+    }
+
+    int before, single, after;
+    split(root, old_position, before, after);
+    split(after, 1, single, after);
+    root = merge(before, after);
+
+    split(root, new_position, before, after);
+    root = merge(merge(before, single), after);
+    parent[root] = NONE;
+}
+
+void TreapOrder::swap_by_vertices(int v, int u) {
+    int pos1 = get_position(v);
+    int pos2 = get_position(u);
+    if (pos1 == pos2) {
+        return;
+    }
+    if (pos1 > pos2) {
+        std::swap(pos1, pos2);
+        std::swap(v, u);
+    }
+
+    // After moving v behind u, u is at position pos2 - 1.
+    move_vertex(v, pos2);
+    move_vertex(u, pos1);
+}
+
+void TreapOrder::swap_by_position(int pos1, int pos2) {
+    swap_by_vertices(get_vertex(pos1), get_vertex(pos2));
+}
+
+void TreapOrder::permute() {
+    std::vector<int> order = position_to_vertex();
+    std::shuffle(order.begin(), order.end(), thread_rng());
+    build(order);
+}
+
+void TreapOrder::collect(int node, std::vector<int> &out) const {
+    // Iterative in-order traversal to avoid deep recursion.
+    std::vector<int> stack;
+    while (node != NONE || !stack.empty()) {
+        while (node != NONE) {
+            stack.push_back(node);
+            node = left[node];
+        }
+        node = stack.back();
+        stack.pop_back();
+        out.push_back(node);
+        node = right[node];
+    }
+}
+
+void TreapOrder::get_vertices(int from, int to, std::vector<int> &out) const {
+    if (from >= to) {
+        return;
+    }
+
+    // Walk down to the vertex at position from, remembering the ancestors
+    // that come after it in the order.
+    std::vector<int> stack;
+    int node = root;
+    int position = from;
+    while (node != NONE) {
+        int leftSize = size_of(left[node]);
+        if (position < leftSize) {
+            stack.push_back(node);
+            node = left[node];
+        } else if (position == leftSize) {
+            stack.push_back(node);
+            break;
+        } else {
+            position -= leftSize + 1;
+            node = right[node];
+        }
+    }
+
+    int remaining = to - from;
+    while (remaining > 0 && !stack.empty()) {
+        node = stack.back();
+        stack.pop_back();
+        out.push_back(node);
+        remaining--;
+
+        node = right[node];
+        while (node != NONE) {
+            stack.push_back(node);
+            node = left[node];
+        }
+    }
+}
+
+std::vector<int> TreapOrder::position_to_vertex() const {
+    std::vector<int> result;
+    result.reserve(size());
+    collect(root, result);
+    return result;
+}
@@ -0,0 +1,101 @@
+#ifndef PACE2024_TREAP_ORDER_HPP
+#define PACE2024_TREAP_ORDER_HPP
+
+#include "order.hpp"
+#include "pace_graph.hpp"
+#include <vector>
+
+/**
+ * TreapOrder stores an order of the free vertices in an implicit treap (a
+ * randomized balanced binary tree keyed by the position). get_position,
+ * get_vertex and move_vertex run in O(log n) instead of O(1), O(1) and
+ * O(|old position - new position|) for Order, which pays off for orders with
+ * 100k+ vertices and long moves.
+ *
+ * It is not a drop-in replacement for Order: it does not track crossings
+ * (no track_crossings, get_crossings, move_cost_change or move_vertex with a
+ * known cost change) and position_to_vertex() is a method. The sifting of
+ * largeGraphHeuristic keeps using Order, since it computes the crossings with
+ * every vertex it passes anyway, which already costs O(move distance). Use
+ * to_order() to hand an order to code that expects Order.
+ *
+ * Every vertex is its own tree node, so no memory is allocated after
+ * construction.
+ */
+class TreapOrder {
+  private:
+    static constexpr int NONE = -1;
+
+    int root = NONE;
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<int> parent;
+    std::vector<int> subtree_size;
+    std::vector<unsigned int> priority;
+
+    int size_of(int node) const {
+        return node == NONE ? 0 : subtree_size[node];
+    }
+    void update(int node);
+
+    /**
+     * Splits the tree with the given root into the first count vertices and
+     * the remaining vertices.
+     */
+    void split(int node, int count, int &first, int &second);
+    int merge(int first, int second);
+
+    /**
+     * Builds the tree for the given vertex sequence in O(n).
+     */
+    void build(const std::vector<int> &position_to_vertex);
+
+    void collect(int node, std::vector<int> &out) const;
+
+  public:
+    /**
+     * Creates a TreapOrder with a given size. The order will be the identity
+     * permutation.
+     */
+    explicit TreapOrder(int size);
+
+    /**
+     * Creates a TreapOrder from a given position_to_vertex vector.
+     */
+    explicit TreapOrder(const std::vector<int> &position_to_vertex);
+
+    explicit TreapOrder(const Order &order)
+        : TreapOrder(order.position_to_vertex) {}
+
+    int size() const { return static_cast<int>(left.size()); }
+
+    int get_position(int vertex) const;
+    int get_vertex(int position) const;
+
+    void move_vertex(int vertex, int new_position);
+    void swap_by_vertices(int v, int u);
+    void swap_by_position(int pos1, int pos2);
+
+    /**
+     * Randomly permutes the order.
+     */
+    void permute();
+
+    /**
+     * Appends the vertices at the positions [from, to) to out in O(log n +
+     * (to - from)).
+     */
+    void get_vertices(int from, int to, std::vector<int> &out) const;
+
+    std::vector<int> position_to_vertex() const;
+
+    Order to_order() const { return Order(position_to_vertex()); }
+
+    long count_crossings(PaceGraph &graph) const {
+        return to_order().count_crossings(graph);
+    }
+
+    TreapOrder clone() const { return *this; }
+};
+
+#endif // PACE2024_TREAP_ORDER_HPP
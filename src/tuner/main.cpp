@@ -0,0 +1,324 @@
+#include "../pace_graph/arguments.hpp"
+#include "../pace_graph/config.hpp"
+#include "../pace_graph/order.hpp"
+#include "../pace_graph/pace_graph.hpp"
+#include "racing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Tunes the parameters of the heuristic solver with F-Race: candidate
+ * configurations run on one instance after the other under a fixed time
+ * limit (ended by SIGTERM, like in the challenge), and configurations that
+ * are significantly worse than the best one are eliminated. The best
+ * remaining configuration is written as a config file for "--config".
+ *
+ * Usage: tuner [--solver ./heuristic_solver] [--instances
+ * data/heuristic_public] [--time-limit 10] [--configurations 12]
+ * [--max-runs 500] [--jobs n] [--solver-threads 1] [--first-test 5]
+ * [--alpha 0.05] [--output tuned.cfg] [--seed s]
+ */
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class TunedParameter {
+  public:
+    std::string key;
+    double min;
+    double max;
+    /** Rounded to integers, which also covers enums and booleans. */
+    bool integer;
+    /** Sampled uniformly on a logarithmic scale. */
+    bool logarithmic;
+};
+
+const std::vector<TunedParameter> TUNED_PARAMETERS = {
+    {"genetic.mode", 0, 2, true, false},
+    {"genetic.forceMoveAllDirectNodesAfterIterationWithNoImprovement", 50,
+     2000, true, true},
+    {"genetic.numberOfForceSwapPositions", 10, 200, true, true},
+    {"genetic.numberOfForceSwapStepSize", 1, 30, true, true},
+    {"genetic.stallEngine", 0, 1, true, false},
+    {"genetic.adaptiveSifting", 0, 1, true, false},
+    {"genetic.elitePoolSize", 0, 20, true, false},
+    {"genetic.pathRelinkingInterval", 4, 64, true, true},
+    {"genetic.siftingTypeInitialSearch", 1, 3, true, false},
+    {"genetic.siftingInsertionTypeInitialSearch", 0, 2, true, false},
+    {"genetic.siftingTypeImprovementSearch", 1, 3, true, false},
+    {"genetic.siftingInsertionTypeImprovementSearch", 0, 2, true, false},
+    {"genetic.populationSize", 4, 32, true, true},
+    {"genetic.ilsMinStrength", 1, 8, true, false},
+    {"genetic.ilsAdaptationWindow", 8, 128, true, true},
+    {"genetic.ilsAcceptance", 0, 2, true, false},
+    {"tabu.candidates", 4, 64, true, true},
+    {"portfolio.numberOfOrders", 1, 4, true, false},
+};
+
+/** The defaults of the solver (an empty config) and random samples. */
+std::vector<Config> sample_configurations(int count, Xoshiro256 &rng) {
+    std::vector<Config> configurations(1);
+    while (configurations.size() < count) {
+        Config config;
+        for (const auto &parameter : TUNED_PARAMETERS) {
+            double u = rng.next_double();
+            if (parameter.logarithmic) {
+                double value = std::exp(
+                    std::log(parameter.min) +
+                    u * (std::log(parameter.max) - std::log(parameter.min)));
+                config.set(parameter.key,
+                           parameter.integer
+                               ? std::to_string(std::lround(value))
+                               : std::to_string(value));
+            } else if (parameter.integer) {
+                long range = std::lround(parameter.max - parameter.min) + 1;
+                config.set(parameter.key,
+                           std::to_string(std::lround(parameter.min) +
+                                          rng.next_below(range)));
+            } else {
+                config.set(parameter.key,
+                           std::to_string(parameter.min +
+                                          u * (parameter.max - parameter.min)));
+            }
+        }
+        configurations.push_back(config);
+    }
+    return configurations;
+}
+
+/** Crossings of the solution in file, infinite if it is invalid. */
+double evaluate(PaceGraph &graph, const fs::path &file) {
+    std::ifstream in(file);
+    std::vector<int> position_to_vertex;
+    std::vector<char> seen(graph.size_free, false);
+    long name;
+    while (in >> name) {
+        long v = name - graph.size_fixed - 1;
+        if (v < 0 || v >= graph.size_free || seen[v]) {
+            return std::numeric_limits<double>::infinity();
+        }
+        seen[v] = true;
+        position_to_vertex.push_back(v);
+    }
+    if (position_to_vertex.size() != graph.size_free) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return Order(position_to_vertex).count_crossings(graph);
+}
+
+class Run {
+  public:
+    /** Index into alive. */
+    int index;
+    pid_t pid;
+    fs::path output;
+    std::chrono::steady_clock::time_point deadline;
+    bool terminated = false;
+};
+
+/**
+ * Runs the solver with every alive configuration on the instance, at most
+ * jobs at a time. Each run gets SIGTERM after timeLimit and SIGKILL 5 seconds
+ * later.
+ * @return the cost of every alive configuration
+ */
+std::vector<double> run_configurations(
+    const std::string &solver, const fs::path &instance,
+    const std::vector<int> &alive, const std::vector<fs::path> &configFiles,
+    const fs::path &directory, std::chrono::milliseconds timeLimit, int jobs,
+    int solverThreads, uint64_t seed) {
+    PaceGraph graph = PaceGraph::from_file(instance);
+    std::vector<double> costs(alive.size(),
+                              std::numeric_limits<double>::infinity());
+    std::vector<Run> running;
+    size_t next = 0;
+
+    while (next < alive.size() || !running.empty()) {
+        while (next < alive.size() && running.size() < jobs) {
+            int configuration = alive[next];
+            fs::path output =
+                directory / ("run_" + std::to_string(configuration) + ".out");
+            std::string seedArgument = std::to_string(seed);
+            std::string threadsArgument = std::to_string(solverThreads);
+            std::string configArgument = configFiles[configuration].string();
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                int in = open(instance.c_str(), O_RDONLY);
+                int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                               0644);
+                int err = open("/dev/null", O_WRONLY);
+                dup2(in, STDIN_FILENO);
+                dup2(out, STDOUT_FILENO);
+                dup2(err, STDERR_FILENO);
+                execl(solver.c_str(), solver.c_str(), "--config",
+                      configArgument.c_str(), "--seed", seedArgument.c_str(),
+                      "--threads", threadsArgument.c_str(), nullptr);
+                _exit(127);
+            }
+            running.push_back(
+                {static_cast<int>(next), pid, output,
+                 std::chrono::steady_clock::now() + timeLimit});
+            next++;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = running.begin(); it != running.end();) {
+            int status;
+            if (waitpid(it->pid, &status, WNOHANG) == it->pid) {
+                if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                    costs[it->index] = evaluate(graph, it->output);
+                }
+                it = running.erase(it);
+                continue;
+            }
+            if (now > it->deadline) {
+                kill(it->pid, it->terminated ? SIGKILL : SIGTERM);
+                it->terminated = true;
+                it->deadline = now + std::chrono::seconds(5);
+            }
+            ++it;
+        }
+    }
+    return costs;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    apply_seed_argument(argc, argv);
+    apply_threads_argument(argc, argv);
+
+    auto argument = [&](const char *name, const char *fallback) {
+        const char *value = get_argument(argc, argv, name);
+        return std::string(value != nullptr ? value : fallback);
+    };
+    const std::string solver = argument("--solver", "./heuristic_solver");
+    const fs::path instanceDirectory =
+        argument("--instances", "data/heuristic_public");
+    const auto timeLimit = std::chrono::milliseconds(static_cast<long>(
+        1000 * std::stod(argument("--time-limit", "10"))));
+    const int numberOfConfigurations =
+        std::stoi(argument("--configurations", "12"));
+    const long maxRuns = std::stol(argument("--max-runs", "500"));
+    const int solverThreads = std::stoi(argument("--solver-threads", "1"));
+    const int jobs = std::stoi(argument(
+        "--jobs",
+        std::to_string(std::max(1, number_of_threads() / solverThreads))
+            .c_str()));
+    const int firstTest = std::stoi(argument("--first-test", "5"));
+    const double alpha = std::stod(argument("--alpha", "0.05"));
+    const fs::path outputFile = argument("--output", "tuned.cfg");
+
+    auto &rng = thread_rng();
+    std::vector<fs::path> instances;
+    for (const auto &entry : fs::directory_iterator(instanceDirectory)) {
+        if (entry.path().extension() == ".gr") {
+            instances.push_back(entry.path());
+        }
+    }
+    std::sort(instances.begin(), instances.end());
+    std::shuffle(instances.begin(), instances.end(), rng);
+
+    fs::path directory = fs::temp_directory_path() /
+                         ("pace_tuner_" + std::to_string(getpid()));
+    fs::create_directories(directory);
+
+    std::vector<Config> configurations =
+        sample_configurations(numberOfConfigurations, rng);
+    std::vector<fs::path> configFiles;
+    for (size_t i = 0; i < configurations.size(); ++i) {
+        configFiles.push_back(directory /
+                              ("candidate_" + std::to_string(i) + ".cfg"));
+        std::ofstream out(configFiles.back());
+        configurations[i].write(out);
+    }
+
+    std::vector<int> alive(configurations.size());
+    std::iota(alive.begin(), alive.end(), 0);
+    // costs[stage][configuration], only filled for configurations that were
+    // alive in the stage.
+    std::vector<std::vector<double>> costs;
+    long runs = 0;
+
+    auto aliveCosts = [&]() {
+        std::vector<std::vector<double>> result;
+        for (const auto &stage : costs) {
+            std::vector<double> row;
+            for (int configuration : alive) {
+                row.push_back(stage[configuration]);
+            }
+            result.push_back(row);
+        }
+        return result;
+    };
+
+    for (const auto &instance : instances) {
+        if (alive.size() <= 1 || runs + alive.size() > maxRuns) {
+            break;
+        }
+        uint64_t seed = rng();
+        std::vector<double> stageCosts =
+            run_configurations(solver, instance, alive, configFiles,
+                               directory, timeLimit, jobs, solverThreads, seed);
+        runs += alive.size();
+
+        costs.emplace_back(configurations.size(),
+                           std::numeric_limits<double>::quiet_NaN());
+        for (size_t i = 0; i < alive.size(); ++i) {
+            costs.back()[alive[i]] = stageCosts[i];
+        }
+
+        size_t before = alive.size();
+        if (costs.size() >= firstTest) {
+            std::vector<bool> survivors = race_survivors(aliveCosts(), alpha);
+            std::vector<int> remaining;
+            for (size_t i = 0; i < alive.size(); ++i) {
+                if (survivors[i]) {
+                    remaining.push_back(alive[i]);
+                }
+            }
+            alive = remaining;
+        }
+        std::cerr << "Stage " << costs.size() << " ("
+                  << instance.filename().string() << "): best cost "
+                  << *std::min_element(stageCosts.begin(), stageCosts.end())
+                  << ", " << alive.size() << " of " << before
+                  << " configurations remain" << std::endl;
+    }
+
+    FriedmanTest test = friedman_test(aliveCosts());
+    int best = alive[0];
+    if (!test.rankSums.empty()) {
+        best = alive[std::min_element(test.rankSums.begin(),
+                                      test.rankSums.end()) -
+                     test.rankSums.begin()];
+    }
+
+    std::ofstream out(outputFile);
+    out << "# Tuned on " << costs.size() << " instances of "
+        << instanceDirectory.string() << " with " << timeLimit.count()
+        << " ms per run (" << runs << " runs), candidate " << best << "\n";
+    configurations[best].write(out);
+    std::cerr << "Wrote candidate " << best << " to " << outputFile.string()
+              << std::endl;
+
+    fs::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "racing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+constexpr int MAX_ITERATIONS = 300;
+constexpr double EPSILON = 1e-14;
+
+/** Regularized lower incomplete gamma function P(a, x). */
+double regularized_gamma(double a, double x) {
+    if (x <= 0) {
+        return 0;
+    }
+    double logPrefix = a * std::log(x) - x - std::lgamma(a);
+
+    if (x < a + 1) {
+        // Series expansion.
+        double term = 1 / a;
+        double sum = term;
+        for (int n = 1; n < MAX_ITERATIONS; ++n) {
+            term *= x / (a + n);
+            sum += term;
+            if (std::abs(term) < std::abs(sum) * EPSILON) {
+                break;
+            }
+        }
+        return sum * std::exp(logPrefix);
+    }
+
+    // Continued fraction for Q(a, x) (modified Lentz).
+    double b = x + 1 - a;
+    double c = 1 / 1e-300;
+    double d = 1 / b;
+    double h = d;
+    for (int n = 1; n < MAX_ITERATIONS; ++n) {
+        double an = -n * (n - a);
+        b += 2;
+        d = an * d + b;
+        d = std::abs(d) < 1e-300 ? 1e-300 : d;
+        c = b + an / c;
+        c = std::abs(c) < 1e-300 ? 1e-300 : c;
+        d = 1 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::abs(delta - 1) < EPSILON) {
+            break;
+        }
+    }
+    return 1 - std::exp(logPrefix) * h;
+}
+
+/** Continued fraction of the incomplete beta function (modified Lentz). */
+double beta_continued_fraction(double x, double a, double b) {
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+    d = std::abs(d) < 1e-300 ? 1e-300 : d;
+    d = 1 / d;
+    double h = d;
+    for (int m = 1; m < MAX_ITERATIONS; ++m) {
+        int m2 = 2 * m;
+        double even = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+        double odd = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+        for (double an : {even, odd}) {
+            d = 1 + an * d;
+            d = std::abs(d) < 1e-300 ? 1e-300 : d;
+            c = 1 + an / c;
+            c = std::abs(c) < 1e-300 ? 1e-300 : c;
+            d = 1 / d;
+            h *= d * c;
+        }
+        if (std::abs(d * c - 1) < EPSILON) {
+            break;
+        }
+    }
+    return h;
+}
+
+/** Regularized incomplete beta function I_x(a, b). */
+double regularized_beta(double x, double a, double b) {
+    if (x <= 0) {
+        return 0;
+    }
+    if (x >= 1) {
+        return 1;
+    }
+    double logPrefix = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                       a * std::log(x) + b * std::log(1 - x);
+    // The continued fraction converges quickly for x < (a + 1) / (a + b + 2).
+    if (x < (a + 1) / (a + b + 2)) {
+        return std::exp(logPrefix) * beta_continued_fraction(x, a, b) / a;
+    }
+    return 1 - std::exp(logPrefix) * beta_continued_fraction(1 - x, b, a) / b;
+}
+
+/** Ranks of values starting at 1, ties get their average rank. */
+std::vector<double> ranks(const std::vector<double> &values) {
+    std::vector<int> indices(values.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(),
+              [&values](int a, int b) { return values[a] < values[b]; });
+
+    std::vector<double> result(values.size());
+    for (size_t begin = 0; begin < indices.size();) {
+        size_t end = begin;
+        while (end < indices.size() &&
+               values[indices[end]] == values[indices[begin]]) {
+            end++;
+        }
+        double averageRank = (begin + 1 + end) / 2.0;
+        for (size_t i = begin; i < end; ++i) {
+            result[indices[i]] = averageRank;
+        }
+        begin = end;
+    }
+    return result;
+}
+
+} // namespace
+
+double chi_squared_cdf(double x, double df) {
+    return regularized_gamma(df / 2, x / 2);
+}
+
+double student_t_cdf(double t, double df) {
+    double tail = 0.5 * regularized_beta(df / (df + t * t), df / 2, 0.5);
+    return t >= 0 ? 1 - tail : tail;
+}
+
+double student_t_quantile(double p, double df) {
+    if (p < 0.5) {
+        return -student_t_quantile(1 - p, df);
+    }
+    double low = 0;
+    double high = 1;
+    while (student_t_cdf(high, df) < p && high < 1e12) {
+        high *= 2;
+    }
+    for (int i = 0; i < 100; ++i) {
+        double middle = (low + high) / 2;
+        if (student_t_cdf(middle, df) < p) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return (low + high) / 2;
+}
+
+namespace {
+
+/** Sum of the squared ranks, needed by the test and the post-hoc test. */
+double squared_rank_sum(const std::vector<std::vector<double>> &costs) {
+    double sum = 0;
+    for (const auto &instance : costs) {
+        for (double rank : ranks(instance)) {
+            sum += rank * rank;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+FriedmanTest friedman_test(const std::vector<std::vector<double>> &costs) {
+    FriedmanTest test;
+    if (costs.empty()) {
+        return test;
+    }
+    const double b = costs.size();
+    const double k = costs[0].size();
+
+    test.rankSums.assign(costs[0].size(), 0);
+    for (const auto &instance : costs) {
+        std::vector<double> instanceRanks = ranks(instance);
+        for (size_t j = 0; j < instanceRanks.size(); ++j) {
+            test.rankSums[j] += instanceRanks[j];
+        }
+    }
+    if (k < 2) {
+        return test;
+    }
+
+    // Conover's formulation, which handles ties.
+    double denominator =
+        squared_rank_sum(costs) - b * k * (k + 1) * (k + 1) / 4;
+    if (denominator <= 0) {
+        // All configurations tie on every instance.
+        return test;
+    }
+    double numerator = 0;
+    for (double rankSum : test.rankSums) {
+        double deviation = rankSum - b * (k + 1) / 2;
+        numerator += deviation * deviation;
+    }
+    test.statistic = (k - 1) * numerator / denominator;
+    test.pValue = 1 - chi_squared_cdf(test.statistic, k - 1);
+    return test;
+}
+
+std::vector<bool> race_survivors(const std::vector<std::vector<double>> &costs,
+                                 double alpha) {
+    if (costs.empty()) {
+        return {};
+    }
+    const double b = costs.size();
+    const double k = costs[0].size();
+    std::vector<bool> survivors(costs[0].size(), true);
+
+    FriedmanTest test = friedman_test(costs);
+    if (b < 2 || k < 2 || test.pValue >= alpha) {
+        return survivors;
+    }
+
+    double best = *std::min_element(test.rankSums.begin(),
+                                    test.rankSums.end());
+    double denominator =
+        squared_rank_sum(costs) - b * k * (k + 1) * (k + 1) / 4;
+    double degrees = (b - 1) * (k - 1);
+    double criticalDifference =
+        student_t_quantile(1 - alpha / 2, degrees) *
+        std::sqrt(2 * b *
+                  std::max(0.0, 1 - test.statistic / (b * (k - 1))) *
+                  denominator / degrees);
+
+    for (size_t j = 0; j < survivors.size(); ++j) {
+        survivors[j] = test.rankSums[j] - best <= criticalDifference;
+    }
+    return survivors;
+}
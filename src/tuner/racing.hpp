@@ -0,0 +1,41 @@
+#ifndef PACE2024_RACING_HPP
+#define PACE2024_RACING_HPP
+
+#include <vector>
+
+/** @return the CDF of the chi-squared distribution with df degrees. */
+double chi_squared_cdf(double x, double df);
+
+/** @return the CDF of Student's t-distribution with df degrees. */
+double student_t_cdf(double t, double df);
+
+/** @return the p-quantile of Student's t-distribution with df degrees. */
+double student_t_quantile(double p, double df);
+
+class FriedmanTest {
+  public:
+    /** Sum of the ranks of every configuration over all instances. */
+    std::vector<double> rankSums;
+    double statistic = 0;
+    double pValue = 1;
+};
+
+/**
+ * Friedman test whether some configuration is better than the others.
+ * Configurations are ranked within every instance, ties get the average
+ * rank.
+ * @param costs costs[instance][configuration], smaller is better
+ */
+FriedmanTest friedman_test(const std::vector<std::vector<double>> &costs);
+
+/**
+ * One step of F-Race: if the Friedman test rejects that all configurations
+ * are equal at level alpha, every configuration whose rank sum differs
+ * significantly from the best one (Conover's post-hoc test) is eliminated.
+ * @param costs costs[instance][configuration], smaller is better
+ * @return for every configuration, whether it stays in the race
+ */
+std::vector<bool> race_survivors(const std::vector<std::vector<double>> &costs,
+                                 double alpha);
+
+#endif // PACE2024_RACING_HPP
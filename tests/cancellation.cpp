@@ -0,0 +1,36 @@
+#include "../src/pace_graph/cancellation.hpp"
+#include "doctest.h"
+#include <thread>
+
+TEST_CASE("Cancellation token") {
+    SUBCASE("Copies share the state") {
+        CancellationToken token;
+        CancellationToken copy = token;
+        CHECK_FALSE(copy.is_cancelled());
+        token.cancel();
+        CHECK(copy.is_cancelled());
+        CHECK_FALSE(copy.has_time_left());
+    }
+
+    SUBCASE("Deadline") {
+        auto token =
+            CancellationToken::with_timeout(std::chrono::milliseconds(20));
+        CHECK_FALSE(token.is_cancelled());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK(token.is_cancelled());
+    }
+
+    SUBCASE("Parent") {
+        CancellationToken parent;
+        auto token =
+            CancellationToken::with_timeout(std::chrono::hours(1), parent);
+        CHECK_FALSE(token.is_cancelled());
+        parent.cancel();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK(token.is_cancelled());
+
+        auto late =
+            CancellationToken::with_timeout(std::chrono::hours(1), parent);
+        CHECK(late.is_cancelled());
+    }
+}
@@ -0,0 +1,165 @@
+#include "../src/pace_graph/crossing_kernels.hpp"
+#include "doctest.h"
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+using crossing_kernels_detail::KernelSet;
+
+/**
+ * The implementations of the instruction sets the CPU supports, without the
+ * scalar one that the others are compared against.
+ */
+std::vector<KernelSet> vectorizedKernelSets() {
+    const auto &all = crossing_kernels_detail::kernel_sets();
+    std::vector<KernelSet> sets;
+    for (size_t i = 1; i < all.size(); ++i) {
+        if (all[i].supported) {
+            sets.push_back(all[i]);
+        }
+    }
+    return sets;
+}
+
+TEST_CASE("Prefix minimum") {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> small(-3, 3);
+    const KernelSet &scalar = crossing_kernels_detail::kernel_sets().front();
+
+    for (int count : {0, 1, 3, 4, 7, 8, 15, 16, 17, 100, 256}) {
+        for (int barrierAt : {-1, 0, count / 2, count - 1}) {
+            std::vector<int> values(count);
+            for (int &value : values) {
+                // Large values must not overflow the 64 bit prefix sums.
+                value = gen() % 4 == 0 ? -2000000000 : small(gen);
+            }
+            if (barrierAt >= 0 && barrierAt < count) {
+                values[barrierAt] = 500000;
+            }
+
+            long start = 7;
+            PrefixMinimum expected{start, LONG_MAX, -1, -1, 0, count, 0};
+            long prefix = start;
+            for (int k = 0; k < count; ++k) {
+                if (values[k] >= 500000) {
+                    expected.scanned = k;
+                    break;
+                }
+                prefix += values[k];
+                expected.negativeTotal += std::min(values[k], 0);
+                if (prefix < expected.minimum) {
+                    expected.minimum = prefix;
+                    expected.first = k;
+                    expected.occurrences = 0;
+                }
+                if (prefix == expected.minimum) {
+                    expected.last = k;
+                    expected.occurrences++;
+                }
+            }
+            expected.total = prefix;
+
+            auto check = [&](const PrefixMinimum &result) {
+                CHECK(result.scanned == expected.scanned);
+                CHECK(result.total == expected.total);
+                CHECK(result.negativeTotal == expected.negativeTotal);
+                CHECK(result.occurrences == expected.occurrences);
+                if (expected.occurrences > 0) {
+                    CHECK(result.minimum == expected.minimum);
+                    CHECK(result.first == expected.first);
+                    CHECK(result.last == expected.last);
+                }
+            };
+
+            PrefixMinimum scalarResult =
+                scalar.prefix_minimum(values.data(), count, start, 500000);
+            check(scalarResult);
+            check(prefix_minimum(values.data(), count, start, 500000));
+            for (const auto &set : vectorizedKernelSets()) {
+                INFO(set.instructionSet);
+                expected = scalarResult;
+                check(set.prefix_minimum(values.data(), count, start,
+                                         500000));
+            }
+        }
+    }
+}
+
+TEST_CASE("Gather row") {
+    std::vector<int> row(50);
+    std::vector<int> vertices(50);
+    for (int i = 0; i < 50; ++i) {
+        row[i] = i * i - 100;
+        vertices[i] = (i * 17) % 50;
+    }
+    const KernelSet &scalar = crossing_kernels_detail::kernel_sets().front();
+
+    std::vector<int> out(50);
+    gather_row(row.data(), vertices.data(), 1, 37, -1, out.data());
+    for (int k = 0; k < 37; ++k) {
+        CHECK(out[k] == -row[vertices[k]]);
+    }
+
+    gather_row(row.data(), vertices.data() + 49, -1, 50, 1, out.data());
+    for (int k = 0; k < 50; ++k) {
+        CHECK(out[k] == row[vertices[49 - k]]);
+    }
+
+    for (int count : {0, 1, 7, 8, 15, 16, 17, 37, 50}) {
+        for (int step : {1, -1}) {
+            for (int sign : {1, -1}) {
+                const int *first =
+                    step == 1 ? vertices.data() : vertices.data() + 49;
+                std::vector<int> expected(50, 0);
+                scalar.gather_row(row.data(), first, step, count, sign,
+                                  expected.data());
+                for (int k = 0; k < count; ++k) {
+                    CHECK(expected[k] == sign * row[first[k * step]]);
+                }
+                for (const auto &set : vectorizedKernelSets()) {
+                    INFO(set.instructionSet);
+                    std::vector<int> result(50, 0);
+                    set.gather_row(row.data(), first, step, count, sign,
+                                   result.data());
+                    CHECK(result == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Sum row after position") {
+    std::mt19937 gen(3);
+    const KernelSet &scalar = crossing_kernels_detail::kernel_sets().front();
+
+    for (int size : {0, 1, 7, 8, 15, 16, 17, 100, 257}) {
+        std::vector<int> row(size);
+        std::vector<int> vertex_to_position(size);
+        for (int v = 0; v < size; ++v) {
+            // Large entries must not overflow the 64 bit sum.
+            row[v] = gen() % 4 == 0 ? 2000000000 : static_cast<int>(gen() % 7);
+            vertex_to_position[v] = v;
+        }
+        std::shuffle(vertex_to_position.begin(), vertex_to_position.end(),
+                     gen);
+
+        for (int position : {-1, 0, size / 2, size - 1}) {
+            long expected = 0;
+            for (int v = 0; v < size; ++v) {
+                expected += vertex_to_position[v] > position ? row[v] : 0;
+            }
+            CHECK(scalar.sum_row_after_position(row.data(),
+                                                vertex_to_position.data(),
+                                                size, position) == expected);
+            CHECK(sum_row_after_position(row.data(), vertex_to_position.data(),
+                                         size, position) == expected);
+            for (const auto &set : vectorizedKernelSets()) {
+                INFO(set.instructionSet);
+                CHECK(set.sum_row_after_position(row.data(),
+                                                 vertex_to_position.data(),
+                                                 size, position) == expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "../src/heuristic_solver/crossover.hpp"
+#include "doctest.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+bool isPermutation(const Order &order, int size) {
+    std::vector<int> sorted = order.position_to_vertex;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> identity(size);
+    std::iota(identity.begin(), identity.end(), 0);
+    return sorted == identity;
+}
+
+TEST_CASE("Crossover") {
+    const int size = 50;
+    Xoshiro256 rng(13);
+    Order first(size);
+    Order second(size);
+    std::shuffle(first.position_to_vertex.begin(),
+                 first.position_to_vertex.end(), rng);
+    std::shuffle(second.position_to_vertex.begin(),
+                 second.position_to_vertex.end(), rng);
+    first = Order(first.position_to_vertex);
+    second = Order(second.position_to_vertex);
+
+    for (int i = 0; i < 20; ++i) {
+        CHECK(isPermutation(order_crossover(first, second, rng), size));
+        CHECK(isPermutation(position_based_crossover(first, second, rng),
+                            size));
+        CHECK(isPermutation(median_rank_crossover(first, second, rng), size));
+    }
+
+    SUBCASE("Equal parents") {
+        CHECK(order_crossover(first, first, rng).position_to_vertex ==
+              first.position_to_vertex);
+        CHECK(position_based_crossover(first, first, rng).position_to_vertex ==
+              first.position_to_vertex);
+        CHECK(median_rank_crossover(first, first, rng).position_to_vertex ==
+              first.position_to_vertex);
+    }
+
+    SUBCASE("Footrule distance") {
+        CHECK(footrule_distance(first, first) == 0);
+        Order swapped = first;
+        swapped.swap_by_position(3, 7);
+        CHECK(footrule_distance(first, swapped) == 8);
+    }
+
+    SUBCASE("Kendall tau distance") {
+        long inversions = 0;
+        for (int u = 0; u < size; ++u) {
+            for (int v = u + 1; v < size; ++v) {
+                bool firstOrder =
+                    first.vertex_to_position[u] < first.vertex_to_position[v];
+                bool secondOrder = second.vertex_to_position[u] <
+                                   second.vertex_to_position[v];
+                inversions += firstOrder != secondOrder;
+            }
+        }
+        CHECK(kendall_tau_distance(first, second) == inversions);
+        CHECK(kendall_tau_distance(second, first) == inversions);
+        CHECK(kendall_tau_distance(first, first) == 0);
+    }
+}
@@ -0,0 +1,446 @@
+#include "../src/heuristic_solver/block_moves.hpp"
+#include "../src/heuristic_solver/elite_pool.hpp"
+#include "../src/heuristic_solver/greedy_insert_solver.hpp"
+#include "../src/heuristic_solver/heuristic_solver.hpp"
+#include "../src/heuristic_solver/local_search.hpp"
+#include "../src/heuristic_solver/perturbation.hpp"
+#include "../src/heuristic_solver/portfolio.hpp"
+#include "../src/heuristic_solver/simulated_annealing.hpp"
+#include "../src/heuristic_solver/tabu_search.hpp"
+#include "../src/pace_graph/parallel.hpp"
+#include "../src/pace_graph/random.hpp"
+#include "doctest.h"
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+PaceGraph getRandomLocalSearchGraph(int fixed, int free, int edgesPerVertex) {
+    std::mt19937 gen(7);
+    std::vector<std::tuple<int, int>> edges;
+    for (int v = 0; v < free; ++v) {
+        for (int i = 0; i < edgesPerVertex; ++i) {
+            edges.emplace_back(gen() % fixed, v);
+        }
+    }
+    return PaceGraph(fixed, free, edges, false);
+}
+
+/** Checks that order contains every vertex in [0, size) exactly once. */
+void checkIsPermutation(const Order &order, int size) {
+    std::vector<int> vertices = order.position_to_vertex;
+    std::sort(vertices.begin(), vertices.end());
+    REQUIRE(vertices.size() == size);
+    for (int i = 0; i < size; ++i) {
+        CHECK(vertices[i] == i);
+    }
+}
+
+/** A random order of the free vertices that tracks its crossings. */
+Order randomTrackedOrder(PaceGraph &graph) {
+    Order order(graph.size_free);
+    order.permute();
+    order.track_crossings(graph);
+    return order;
+}
+
+Order parallelLocalSearch(PaceGraph &graph, int threads) {
+    set_number_of_threads(threads);
+    set_random_seed(3);
+
+    Order order = randomTrackedOrder(graph);
+
+    LocalSearchParameter parameter;
+    parameter.siftingInsertionType = SiftingInsertionType::Random;
+    parameter.parallelSifting = true;
+    local_search(graph, order, parameter, CancellationToken());
+    return order;
+}
+
+TEST_CASE("Parallel sifting") {
+    PaceGraph graph = getRandomLocalSearchGraph(300, 1200, 3);
+    graph.init_crossing_matrix_if_necessary();
+
+    Order twoThreads = parallelLocalSearch(graph, 2);
+    Order fourThreads = parallelLocalSearch(graph, 4);
+    set_number_of_threads(1);
+
+    CHECK(twoThreads.get_crossings() == twoThreads.count_crossings(graph));
+    CHECK(twoThreads.position_to_vertex == fourThreads.position_to_vertex);
+
+    // The result is a local optimum for sequential sifting as well.
+    LocalSearchParameter parameter;
+    parameter.exhaustiveSifting = false;
+    parameter.siftingInsertionType = SiftingInsertionType::First;
+    CHECK(local_search(graph, twoThreads, parameter,
+                       CancellationToken()) == 0);
+}
+
+TEST_CASE("Block moves") {
+    PaceGraph graph = getRandomLocalSearchGraph(40, 60, 2);
+    graph.init_crossing_matrix_if_necessary();
+    set_random_seed(5);
+
+    Order order = randomTrackedOrder(graph);
+
+    SUBCASE("Cost change of a block swap") {
+        WindowPairSums pairSums(graph, order, 8);
+        long before = order.count_crossings(graph);
+        long costChange = pairSums.swap_cost_change(10, 13, 18);
+        order.swap_blocks(10, 13, 18, costChange);
+        CHECK(order.count_crossings(graph) == before + costChange);
+
+        pairSums.update(10, 17);
+        CHECK(pairSums.get(5, 8) == WindowPairSums(graph, order, 8).get(5, 8));
+    }
+
+    SUBCASE("Search") {
+        long before = order.get_crossings();
+        long improvement = block_moves(graph, order, 8, CancellationToken());
+        CHECK(improvement <= 0);
+        CHECK(order.get_crossings() == before + improvement);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        CHECK(block_moves(graph, order, 8, CancellationToken()) == 0);
+    }
+}
+
+TEST_CASE("Worklist sifting") {
+    PaceGraph graph = getRandomLocalSearchGraph(200, 300, 3);
+    graph.init_crossing_matrix_if_necessary();
+    set_random_seed(11);
+
+    Order order = randomTrackedOrder(graph);
+
+    // Random insertion makes moves of cost 0 in the verifying sweep, which
+    // may enable improving moves of vertices sifted before.
+    LocalSearchParameter parameter;
+    parameter.worklistSifting = true;
+    parameter.siftingInsertionType = SiftingInsertionType::First;
+    local_search(graph, order, parameter, CancellationToken());
+    CHECK(order.get_crossings() == order.count_crossings(graph));
+
+    LocalSearchParameter sweepParameter;
+    sweepParameter.exhaustiveSifting = false;
+    sweepParameter.siftingInsertionType = SiftingInsertionType::First;
+    CHECK(local_search(graph, order, sweepParameter, CancellationToken()) ==
+          0);
+
+    SUBCASE("Starting with the changed vertices") {
+        std::vector<int> changed = {order.get_vertex(5), order.get_vertex(250)};
+        order.swap_by_position(5, 250);
+        local_search(graph, order, parameter, CancellationToken(), changed);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        CHECK(local_search(graph, order, sweepParameter,
+                           CancellationToken()) == 0);
+    }
+}
+
+TEST_CASE("Tabu search") {
+    PaceGraph graph = getRandomLocalSearchGraph(100, 150, 3);
+    graph.init_crossing_matrix_if_necessary();
+    set_random_seed(17);
+
+    Order order = randomTrackedOrder(graph);
+
+    SUBCASE("Best insertion move") {
+        int v = order.get_vertex(70);
+        int position;
+        long costChange = best_insertion_move(graph, order, v, position);
+        CHECK(position != 70);
+
+        long before = order.get_crossings();
+        order.move_vertex(v, position);
+        CHECK(order.get_crossings() == before + costChange);
+        CHECK(order.count_crossings(graph) == before + costChange);
+    }
+
+    SUBCASE("Search") {
+        LocalSearchParameter parameter;
+        local_search(graph, order, parameter, CancellationToken());
+        long before = order.get_crossings();
+
+        TabuSearchParameter tabuParameter;
+        tabuParameter.maxMovesWithoutImprovement = 500;
+        long improvement =
+            tabu_search(graph, order, tabuParameter, CancellationToken());
+        CHECK(improvement <= 0);
+        CHECK(order.get_crossings() == before + improvement);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+}
+
+TEST_CASE("Simulated annealing") {
+    PaceGraph graph = getRandomLocalSearchGraph(100, 150, 3);
+    graph.init_crossing_matrix_if_necessary();
+    set_random_seed(23);
+
+    Order start = randomTrackedOrder(graph);
+    LocalSearchParameter localSearchParameter;
+    Order localOptimum = start;
+    local_search(graph, localOptimum, localSearchParameter,
+                 CancellationToken());
+
+    SUBCASE("Move cost change") {
+        int v = start.get_vertex(40);
+        long costChange = start.move_cost_change(v, 90);
+        long before = start.get_crossings();
+        start.move_vertex(v, 90);
+        CHECK(start.count_crossings(graph) == before + costChange);
+    }
+
+    for (int replicas : {1, 4}) {
+        SUBCASE(replicas == 1 ? "Annealing" : "Parallel tempering") {
+            SimulatedAnnealingParameter parameter;
+            parameter.sweepsPerCycle = 20;
+            parameter.numberOfReplicas = replicas;
+            SimulatedAnnealing simulatedAnnealing(
+                [](int it) { return it < 60; }, parameter);
+            Order order = simulatedAnnealing.solve(graph);
+
+            checkIsPermutation(order, graph.size_free);
+            CHECK(order.get_crossings() == order.count_crossings(graph));
+        }
+    }
+
+    SUBCASE("Stopped by the annealing token") {
+        // Only the token ends the annealing, the best order must still get
+        // its final local search and match a run that ends after as many
+        // sweeps. Cancelling at a fixed sweep keeps the runs comparable.
+        set_random_seed(31);
+        SimulatedAnnealing byIterations([](int it) { return it < 60; },
+                                        SimulatedAnnealingParameter());
+        Order expected = byIterations.solve(graph);
+
+        set_random_seed(31);
+        CancellationToken annealingCancellation;
+        SimulatedAnnealing byToken(
+            [annealingCancellation](int it) {
+                if (it == 60) {
+                    annealingCancellation.cancel();
+                }
+                return true;
+            },
+            SimulatedAnnealingParameter(), CancellationToken(),
+            annealingCancellation);
+        Order order = byToken.solve(graph);
+
+        checkIsPermutation(order, graph.size_free);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        CHECK(order.position_to_vertex == expected.position_to_vertex);
+    }
+}
+
+TEST_CASE("Elite pool and path relinking") {
+    PaceGraph graph = getRandomLocalSearchGraph(100, 150, 3);
+    graph.init_crossing_matrix_if_necessary();
+    set_random_seed(29);
+    LocalSearchParameter parameter;
+
+    std::vector<Order> optima;
+    for (int i = 0; i < 4; ++i) {
+        Order order = randomTrackedOrder(graph);
+        local_search(graph, order, parameter, CancellationToken());
+        optima.push_back(order);
+    }
+
+    SUBCASE("Insert") {
+        ElitePool pool(2, graph.size_free);
+        CHECK(pool.insert(optima[0], optima[0].get_crossings()));
+        // Equal to a member that is at least as good.
+        CHECK_FALSE(pool.insert(optima[0], optima[0].get_crossings()));
+        CHECK(pool.size() == 1);
+
+        // Replaces the similar member, as it is cheaper.
+        CHECK(pool.insert(optima[0], optima[0].get_crossings() - 1));
+        CHECK(pool.size() == 1);
+        CHECK(pool[0].cost == optima[0].get_crossings() - 1);
+
+        pool.insert(optima[1], optima[1].get_crossings());
+        CHECK(pool.size() == 2);
+        // Full, so only cheaper orders replace the most expensive member.
+        long worst = std::max(pool[0].cost, pool[1].cost);
+        CHECK_FALSE(pool.insert(optima[2], worst));
+        CHECK(pool.insert(optima[2], 0));
+        CHECK(pool.size() == 2);
+    }
+
+    SUBCASE("Path relinking") {
+        Order relinked = path_relinking(graph, optima[0], optima[1], 3,
+                                        parameter, CancellationToken());
+        CHECK(relinked.get_crossings() == relinked.count_crossings(graph));
+
+        Order same = path_relinking(graph, optima[0], optima[0], 3, parameter,
+                                    CancellationToken());
+        CHECK(same.position_to_vertex == optima[0].position_to_vertex);
+    }
+}
+
+TEST_CASE("Perturbation") {
+    PaceGraph graph = getRandomLocalSearchGraph(100, 150, 3);
+    graph.init_crossing_matrix_if_necessary();
+    Xoshiro256 rng(31);
+
+    Order order(graph.size_free);
+    order.track_crossings(graph);
+
+    for (auto type :
+         {PerturbationType::Insertions, PerturbationType::SegmentShuffle}) {
+        std::vector<int> changedVertices = perturb(order, type, 10, 20, rng);
+        CHECK(changedVertices.size() == 10);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+
+        checkIsPermutation(order, graph.size_free);
+        for (int i = 0; i < graph.size_free; ++i) {
+            CHECK(order.get_position(order.get_vertex(i)) == i);
+        }
+
+        LocalSearchParameter parameter;
+        parameter.worklistSifting = true;
+        local_search(graph, order, parameter, CancellationToken(),
+                     changedVertices);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+}
+
+TEST_CASE("Sifting bandit") {
+    SiftingBandit bandit;
+    REQUIRE(bandit.size() == 9);
+
+    // Every arm is tried once first.
+    for (int i = 0; i < bandit.size(); ++i) {
+        int arm = bandit.select();
+        CHECK(arm == i);
+        bandit.update(arm, arm == 4 ? 1000 : 10, 100);
+    }
+    int best = 0;
+    for (int i = 0; i < 50; ++i) {
+        int arm = bandit.select();
+        best += arm == 4;
+        bandit.update(arm, arm == 4 ? 1000 : 10, 100);
+    }
+    CHECK(best > 40);
+
+    SUBCASE("Local search") {
+        PaceGraph graph = getRandomLocalSearchGraph(100, 150, 3);
+        graph.init_crossing_matrix_if_necessary();
+        SiftingBandit localSearchBandit;
+        LocalSearchParameter parameter;
+        parameter.bandit = &localSearchBandit;
+
+        Order order = randomTrackedOrder(graph);
+        local_search(graph, order, parameter, CancellationToken());
+        CHECK(localSearchBandit[0].pulls == 1);
+        CHECK(localSearchBandit[0].rateSum > 0);
+        CHECK(parameter.siftingType == localSearchBandit[0].siftingType);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+}
+
+TEST_CASE("Initial order portfolio") {
+    PaceGraph graph = getRandomLocalSearchGraph(40, 50, 3);
+    graph.init_crossing_matrix_if_necessary();
+
+    PortfolioParameter parameter;
+    parameter.numberOfOrders = 3;
+    std::vector<Order> orders =
+        initial_orders(graph, parameter, CancellationToken());
+    REQUIRE(!orders.empty());
+    CHECK(orders.size() <= 3);
+
+    long previousCost = 0;
+    for (auto &order : orders) {
+        checkIsPermutation(order, graph.size_free);
+        long cost = order.count_crossings(graph);
+        CHECK(cost >= previousCost);
+        previousCost = cost;
+    }
+
+    // Cancelled before the start, the mean positions are still computed.
+    CancellationToken cancelled;
+    cancelled.cancel();
+    orders = initial_orders(graph, parameter, cancelled);
+    REQUIRE(!orders.empty());
+    CHECK(orders[0].count_crossings(graph) <
+          Order(graph.size_free).count_crossings(graph));
+}
+
+TEST_CASE("Greedy insertion") {
+    SUBCASE("Random graph") {
+        PaceGraph graph = getRandomLocalSearchGraph(40, 60, 3);
+        GreedyInsertSolver solver([](int) { return true; });
+        Order order = solver.solve(graph);
+        REQUIRE(graph.crossing.is_initialized());
+
+        checkIsPermutation(order, graph.size_free);
+        CHECK(order.count_crossings(graph) <
+              Order(graph.size_free).count_crossings(graph));
+    }
+
+    // Free vertex v is adjacent to the fixed vertices v and v + 1, the only
+    // order without crossings is 0, 1, ...
+    auto chain = [](int size) {
+        std::vector<std::tuple<int, int>> edges;
+        for (int v = 0; v < size; ++v) {
+            edges.emplace_back(v, v);
+            edges.emplace_back(v + 1, v);
+        }
+        return PaceGraph(size + 1, size, edges, false);
+    };
+
+    SUBCASE("With crossing matrix") {
+        PaceGraph graph = chain(200);
+        GreedyInsertSolver solver([](int) { return true; });
+        CHECK(solver.solve(graph).count_crossings(graph) == 0);
+    }
+
+    SUBCASE("Without crossing matrix") {
+        PaceGraph graph = chain(MAX_MATRIX_SIZE + 1);
+        GreedyInsertSolver solver([](int) { return true; });
+        Order order = solver.solve(graph);
+        CHECK(!graph.crossing.is_initialized());
+        CHECK(order.count_crossings(graph) == 0);
+    }
+
+    SUBCASE("Cancelled") {
+        PaceGraph graph = chain(50);
+        CancellationToken cancelled;
+        cancelled.cancel();
+        GreedyInsertSolver solver([](int) { return true; },
+                                  GreedyInsertParameter(), cancelled);
+        CHECK(solver.solve(graph).position_to_vertex.size() == 50);
+    }
+}
+
+TEST_CASE("Large graph heuristic") {
+    PaceGraph graph = getRandomLocalSearchGraph(100, 400, 3);
+    REQUIRE(!graph.crossing.is_initialized());
+    long medianCost = initial_orders(graph, PortfolioParameter(),
+                                     CancellationToken())
+                          .front()
+                          .count_crossings(graph);
+
+    LargeGraphParameter parameter;
+    parameter.maxMoveDistance = 100;
+    parameter.minSegmentLength = 60;
+    parameter.segmentMargin = 10;
+
+    auto check = [&](const Order &order) {
+        checkIsPermutation(order, graph.size_free);
+        CHECK(Order(order.position_to_vertex).count_crossings(graph) <
+              medianCost);
+    };
+
+    SUBCASE("Sequential") {
+        parameter.parallelSegments = false;
+        check(largeGraphHeuristic(graph, CancellationToken(),
+                                  CancellationToken(), parameter));
+    }
+
+    SUBCASE("Parallel segments") {
+        int threads = number_of_threads();
+        set_number_of_threads(4);
+        check(largeGraphHeuristic(graph, CancellationToken(),
+                                  CancellationToken(), parameter));
+        set_number_of_threads(threads);
+    }
+}
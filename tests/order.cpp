@@ -0,0 +1,112 @@
+#include "../src/pace_graph/order.hpp"
+#include "../src/pace_graph/pace_graph.hpp"
+#include "../src/pace_graph/treap_order.hpp"
+#include "doctest.h"
+#include <random>
+#include <sstream>
+
+PaceGraph getOrderTestGraph() {
+    std::string graph_gr =
+        R"(p ocr 4 6 12
+1 5
+1 8
+2 6
+2 10
+3 5
+3 9
+4 7
+4 6
+1 10
+3 7
+2 8
+4 9
+)";
+    std::istringstream gr_stream(graph_gr);
+    return PaceGraph::from_gr(gr_stream);
+}
+
+TEST_CASE("Tracked crossings") {
+    PaceGraph graph = getOrderTestGraph();
+    graph.init_crossing_matrix_if_necessary();
+
+    Order order(graph.size_free);
+    CHECK(order.track_crossings(graph));
+    CHECK(order.get_crossings() == order.count_crossings(graph));
+
+    SUBCASE("Move vertex") {
+        order.move_vertex(0, 5);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.move_vertex(4, 1);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.move_vertex(2, 2);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+
+    SUBCASE("Swap vertices") {
+        order.swap_by_vertices(1, 4);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.swap_by_vertices(5, 0);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.swap_by_position(2, 3);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+
+    SUBCASE("Permute") {
+        order.permute();
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+
+    SUBCASE("Constraint") {
+        order.swap_by_vertices(0, 3);
+        CHECK(order.set_a_lt_b(0, 3));
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.move_vertex(0, 0);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+        order.unset_a_lt_b(0, 3);
+        CHECK(order.get_crossings() == order.count_crossings(graph));
+    }
+}
+
+TEST_CASE("Untracked crossings without matrix") {
+    PaceGraph graph = getOrderTestGraph();
+    Order order(graph.size_free);
+
+    CHECK_FALSE(order.track_crossings(graph));
+    CHECK_FALSE(order.is_tracking_crossings());
+}
+
+TEST_CASE("Treap order behaves like order") {
+    const int size = 200;
+    Order order(size);
+    order.permute();
+    TreapOrder treapOrder(order);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, size - 1);
+    for (int i = 0; i < 2000; ++i) {
+        int v = dis(gen);
+        int u = dis(gen);
+        if (i % 3 == 0) {
+            order.swap_by_vertices(v, u);
+            treapOrder.swap_by_vertices(v, u);
+        } else {
+            order.move_vertex(v, u);
+            treapOrder.move_vertex(v, u);
+        }
+        CHECK(treapOrder.get_position(v) == order.get_position(v));
+        CHECK(treapOrder.get_vertex(u) == order.get_vertex(u));
+    }
+
+    CHECK(treapOrder.position_to_vertex() == order.position_to_vertex);
+
+    std::vector<int> window;
+    treapOrder.get_vertices(17, 42, window);
+    CHECK(window == std::vector<int>(order.position_to_vertex.begin() + 17,
+                                     order.position_to_vertex.begin() + 42));
+
+    treapOrder.permute();
+    Order permuted = treapOrder.to_order();
+    for (int v = 0; v < size; ++v) {
+        CHECK(treapOrder.get_position(v) == permuted.get_position(v));
+    }
+}
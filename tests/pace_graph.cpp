@@ -1,9 +1,16 @@
+#include "../src/pace_graph/config.hpp"
 #include "../src/pace_graph/pace_graph.hpp"
+#include "../src/pace_graph/parallel.hpp"
+#include "../src/pace_graph/radix_sort.hpp"
+#include "../src/pace_graph/random.hpp"
 #include "doctest.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 TEST_CASE("Remove vertex") {
     std::string graph_gr =
@@ -67,9 +74,55 @@ TEST_CASE("Remove vertex") {
 
         CHECK(graph.crossing.matrix_diff[1][0] == -1);
         CHECK(graph.crossing.matrix_diff[1][1] == 0);
+
+        CHECK(graph.crossing.get_positive_diff_sum(0) == 1);
+        CHECK(graph.crossing.get_positive_diff_sum(1) == 0);
+
+        graph.crossing.set_a_lt_b(0, 1);
+        CHECK(graph.crossing.get_positive_diff_sum(0) == 0);
+        CHECK(graph.crossing.get_positive_diff_sum(1) == FIXED - 1);
+        graph.crossing.unset_a_lt_b(0, 1);
+        CHECK(graph.crossing.get_positive_diff_sum(0) == 1);
+        CHECK(graph.crossing.get_positive_diff_sum(1) == 0);
     }
 }
 
+TEST_CASE("Constraint overlay") {
+    std::string graph_gr =
+        R"(p ocr 4 4 8
+1 6
+1 8
+2 6
+2 7
+3 5
+3 7
+4 5
+4 8
+)";
+    std::istringstream gr_stream(graph_gr);
+    PaceGraph graph = PaceGraph::from_gr(gr_stream);
+    graph.init_crossing_matrix_if_necessary();
+    int *sharedRow = graph.crossing.matrix_diff[0];
+    int before = sharedRow[1];
+
+    auto overlay = graph.constraint_overlay();
+    CHECK(overlay->crossing.matrix_diff[0] == sharedRow);
+
+    CHECK(overlay->crossing.set_a_lt_b(1, 0));
+    CHECK(overlay->crossing.lt(1, 0));
+    CHECK_FALSE(graph.crossing.lt(1, 0));
+    CHECK(sharedRow[1] == before);
+    CHECK(overlay->crossing.matrix_diff[0] != sharedRow);
+    CHECK(overlay->crossing.matrix_diff[0][1] == before + FIXED);
+    CHECK(overlay->crossing.get_positive_diff_sum(0) !=
+          graph.crossing.get_positive_diff_sum(0));
+
+    overlay->crossing.unset_a_lt_b(1, 0);
+    CHECK(overlay->crossing.matrix_diff[0] == sharedRow);
+    CHECK(overlay->crossing.get_positive_diff_sum(0) ==
+          graph.crossing.get_positive_diff_sum(0));
+}
+
 TEST_CASE("SPLIT_GRAPH_GR") {
     std::string graph_gr =
         R"(p ocr 4 4 8
@@ -105,3 +158,201 @@ TEST_CASE("SPLIT_GRAPH_GR") {
 4 5
 )") == 0);
 }
+
+TEST_CASE("Cutwidth order") {
+    std::string graph_gr =
+        R"(p ocr 3 3 4 2
+1
+6
+2
+4
+3
+5
+1 6
+2 4
+2 6
+3 5
+)";
+    std::istringstream gr_stream(graph_gr);
+    PaceGraph graph = PaceGraph::from_gr(gr_stream);
+    CHECK(graph.is_cutwidth_graph);
+    CHECK(graph.neighbors_free[2] == std::vector<int>{0, 1});
+    CHECK(graph.cutwidth_order() == std::vector<int>{2, 0, 1});
+
+    auto subgraph = graph.induced_subgraphs_free({2, 1});
+    CHECK(subgraph->cutwidth_order() == std::vector<int>{0, 1});
+
+    std::istringstream plain("p ocr 1 1 1\n1 2\n");
+    CHECK(PaceGraph::from_gr(plain).cutwidth_order().empty());
+}
+
+TEST_CASE("Config") {
+    std::istringstream in("# tuned\n"
+                          "genetic.populationSize = 8\n"
+                          "\n"
+                          "  annealing.startAcceptance=0.25  \n"
+                          "local_search.blockMoves = true\n");
+    Config config = Config::from_stream(in);
+    CHECK(config.contains("genetic.populationSize"));
+    CHECK_FALSE(config.contains("tuned"));
+
+    int size = 16;
+    double acceptance = 0.3;
+    bool blockMoves = false;
+    int missing = 7;
+    config.load("genetic.populationSize", size);
+    config.load("annealing.startAcceptance", acceptance);
+    config.load("local_search.blockMoves", blockMoves);
+    config.load("genetic.missing", missing);
+    CHECK(size == 8);
+    CHECK(acceptance == 0.25);
+    CHECK(blockMoves);
+    CHECK(missing == 7);
+
+    std::ostringstream out;
+    config.write(out);
+    std::istringstream written(out.str());
+    Config reread = Config::from_stream(written);
+    size = 0;
+    reread.load("genetic.populationSize", size);
+    CHECK(size == 8);
+
+    std::istringstream invalid("genetic.populationSize 8\n");
+    CHECK_THROWS_AS(Config::from_stream(invalid), std::invalid_argument);
+}
+
+TEST_CASE("Radix sort") {
+    RadixSorter sorter;
+    std::vector<int> indices;
+
+    SUBCASE("Matches stable sort") {
+        std::vector<double> keys = {3.5,  -1,   0.0, 7,    -0.0, 3.5,
+                                    -2.5, 1e12, 7,   -1e9, 0.25, -1};
+        std::vector<int> expected(keys.size());
+        for (int i = 0; i < keys.size(); ++i) {
+            expected[i] = i;
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+                         [&](int a, int b) { return keys[a] < keys[b]; });
+
+        sorter.sort_indices(keys, indices);
+        CHECK(indices == expected);
+
+        // The buffers are reused.
+        sorter.sort_indices(keys, indices);
+        CHECK(indices == expected);
+    }
+
+    SUBCASE("NaN comes last") {
+        std::vector<double> keys = {2, std::nan(""), 1, 0};
+        sorter.sort_indices(keys, indices);
+        CHECK(indices == std::vector<int>{3, 2, 0, 1});
+    }
+
+    SUBCASE("Empty") {
+        sorter.sort_indices({}, indices);
+        CHECK(indices.empty());
+    }
+}
+
+TEST_CASE("Crossing row sums") {
+    Xoshiro256 rng(7);
+    std::vector<std::tuple<int, int>> edges;
+    for (int a = 0; a < 30; ++a) {
+        for (int v = 0; v < 25; ++v) {
+            if (rng.next_below(4) == 0) {
+                edges.emplace_back(a, v);
+            }
+        }
+    }
+    PaceGraph graph(30, 25, edges, false);
+
+    std::vector<long> sums;
+    graph.crossing_row_sums(sums);
+    graph.init_crossing_matrix_if_necessary();
+    REQUIRE(sums.size() == graph.size_free);
+    for (int u = 0; u < graph.size_free; ++u) {
+        long expected = 0;
+        for (int v = 0; v < graph.size_free; ++v) {
+            expected += graph.crossing.matrix[u][v];
+        }
+        CHECK(sums[u] == expected);
+    }
+}
+
+TEST_CASE("Crossing number with multi-edges") {
+    Xoshiro256 rng(11);
+    std::vector<std::tuple<int, int>> edges;
+    for (int v = 0; v < 20; ++v) {
+        for (int i = 0; i < 8; ++i) {
+            edges.emplace_back(rng.next_below(6), v);
+        }
+    }
+    PaceGraph graph(6, 20, edges, false);
+
+    for (int u = 0; u < graph.size_free; ++u) {
+        for (int v = 0; v < graph.size_free; ++v) {
+            int expected_u_v = 0;
+            int expected_v_u = 0;
+            for (int a : graph.neighbors_free[u]) {
+                for (int b : graph.neighbors_free[v]) {
+                    expected_u_v += b < a;
+                    expected_v_u += a < b;
+                }
+            }
+            auto [u_v, v_u] = graph.calculatingCrossingNumber(u, v);
+            CHECK(u_v == expected_u_v);
+            CHECK(v_u == expected_v_u);
+        }
+    }
+}
+
+TEST_CASE("Thread generators") {
+    set_random_seed(5);
+    // Another thread asking first does not take the stream of this one.
+    uint64_t otherFirst;
+    std::thread([&]() { otherFirst = thread_rng()(); }).join();
+    uint64_t first = thread_rng()();
+    CHECK(first == make_rng(0)());
+    CHECK(otherFirst != first);
+
+    SUBCASE("Scope") {
+        Xoshiro256 expected = thread_rng();
+        {
+            ThreadRngScope scope(42);
+            CHECK(thread_rng()() == make_rng(42)());
+        }
+        CHECK(thread_rng()() == expected());
+    }
+}
+
+TEST_CASE("Thread team") {
+    int threads = number_of_threads();
+    set_number_of_threads(4);
+    ThreadTeam team;
+    set_number_of_threads(threads);
+    CHECK(team.size() == 4);
+
+    // The team is reused for many small loops.
+    std::vector<int> counts(1000, 0);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<char> used(team.size(), false);
+        team.parallel_for(0, 1000, 100, [&](int from, int to, int thread) {
+            used[thread] = true;
+            for (int i = from; i < to; ++i) {
+                counts[i]++;
+            }
+        });
+        CHECK(std::count(used.begin(), used.end(), true) == 4);
+    }
+    CHECK(std::count(counts.begin(), counts.end(), 50) == 1000);
+
+    // Too small to be split.
+    int calls = 0;
+    team.parallel_for(0, 10, 100, [&](int from, int to, int thread) {
+        CHECK(from == 0);
+        CHECK(to == 10);
+        calls++;
+    });
+    CHECK(calls == 1);
+}
@@ -0,0 +1,48 @@
+#include "../src/tuner/racing.hpp"
+#include "doctest.h"
+#include <vector>
+
+TEST_CASE("Distributions") {
+    CHECK(chi_squared_cdf(3.841459, 1) == doctest::Approx(0.95).epsilon(1e-5));
+    CHECK(chi_squared_cdf(11.0705, 5) == doctest::Approx(0.95).epsilon(1e-5));
+    CHECK(chi_squared_cdf(40, 10) == doctest::Approx(0.99998).epsilon(1e-4));
+
+    CHECK(student_t_cdf(0, 7) == doctest::Approx(0.5));
+    CHECK(student_t_quantile(0.975, 10) ==
+          doctest::Approx(2.228139).epsilon(1e-5));
+    CHECK(student_t_quantile(0.975, 1000) ==
+          doctest::Approx(1.962339).epsilon(1e-5));
+    CHECK(student_t_quantile(0.025, 10) ==
+          doctest::Approx(-2.228139).epsilon(1e-5));
+}
+
+TEST_CASE("Friedman test") {
+    SUBCASE("Ties") {
+        std::vector<std::vector<double>> costs = {{1, 1, 1}, {5, 5, 5}};
+        FriedmanTest test = friedman_test(costs);
+        CHECK(test.pValue == 1);
+        CHECK(test.rankSums == std::vector<double>{4, 4, 4});
+    }
+
+    SUBCASE("Consistent ranking") {
+        // Configuration 2 is always the best, 0 always the worst.
+        std::vector<std::vector<double>> costs;
+        for (int i = 0; i < 8; ++i) {
+            costs.push_back({30.0 + i, 20.0 + i, 10.0 + i, 20.0 + i});
+        }
+        FriedmanTest test = friedman_test(costs);
+        CHECK(test.rankSums == std::vector<double>{32, 20, 8, 20});
+        CHECK(test.pValue < 0.001);
+
+        std::vector<bool> survivors = race_survivors(costs, 0.05);
+        CHECK(survivors == std::vector<bool>{false, false, true, false});
+    }
+
+    SUBCASE("Not enough evidence") {
+        std::vector<std::vector<double>> costs = {
+            {1, 2, 3}, {3, 1, 2}, {2, 3, 1}};
+        CHECK(friedman_test(costs).pValue > 0.5);
+        CHECK(race_survivors(costs, 0.05) ==
+              std::vector<bool>{true, true, true});
+    }
+}